@@ -0,0 +1,166 @@
+/**
+ * BasisFactor.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "BasisFactor.h"
+
+// Entries smaller than this are dropped, pivots smaller than this make the basis singular
+#define FACTOR_DROP_TOLERANCE  1e-14
+#define FACTOR_PIVOT_TOLERANCE 1e-9
+
+BasisFactor::BasisFactor() {
+    m = 0;
+}
+
+BasisFactor::~BasisFactor() {
+}
+
+bool BasisFactor::factorise(int numRows, const vector<int>& beg, const vector<int>& ind, const vector<double>& val,
+                            vector<int>& singularPos, vector<int>& freeRows) {
+    m = numRows;
+    pivRow.clear();
+    pivPos.clear();
+    lBeg.assign(1, 0);
+    lInd.clear();
+    lVal.clear();
+    uBeg.assign(1, 0);
+    uInd.clear();
+    uVal.clear();
+    uDiag.clear();
+    etaPos.clear();
+    etaBeg.assign(1, 0);
+    etaInd.clear();
+    etaVal.clear();
+    etaPivot.clear();
+    singularPos.clear();
+    freeRows.clear();
+
+    // Sparsest columns first
+    vector<int> order(m);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&beg](int a, int b) { return beg[a+1] - beg[a] < beg[b+1] - beg[b]; });
+
+    vector<char> pivoted(m, 0);
+    work.assign(m, 0.0);
+
+    for (int pos : order) {
+        int k = (int)pivRow.size();
+        for (int e = beg[pos]; e < beg[pos+1]; e++) work[ind[e]] += val[e];
+
+        for (int p = 0; p < k; p++) {
+            double v = work[pivRow[p]];
+            if (v == 0) continue;
+            for (int e = lBeg[p]; e < lBeg[p+1]; e++) work[lInd[e]] -= lVal[e] * v;
+        }
+
+        int    row = -1;
+        double best = FACTOR_PIVOT_TOLERANCE;
+        for (int i = 0; i < m; i++) {
+            if (!pivoted[i] && fabs(work[i]) > best) {
+                best = fabs(work[i]);
+                row  = i;
+            }
+        }
+
+        if (row == -1) {
+            singularPos.push_back(pos);
+            for (int i = 0; i < m; i++) work[i] = 0;
+            continue;
+        }
+
+        for (int p = 0; p < k; p++) {
+            double v = work[pivRow[p]];
+            if (fabs(v) > FACTOR_DROP_TOLERANCE) {
+                uInd.push_back(p);
+                uVal.push_back(v);
+            }
+            work[pivRow[p]] = 0;
+        }
+        uBeg.push_back((int)uInd.size());
+
+        double pivot = work[row];
+        uDiag.push_back(pivot);
+        pivRow.push_back(row);
+        pivPos.push_back(pos);
+        pivoted[row] = 1;
+        work[row] = 0;
+
+        for (int i = 0; i < m; i++) {
+            if (work[i] == 0) continue;
+            if (fabs(work[i]) > FACTOR_DROP_TOLERANCE) {
+                lInd.push_back(i);
+                lVal.push_back(work[i] / pivot);
+            }
+            work[i] = 0;
+        }
+        lBeg.push_back((int)lInd.size());
+    }
+
+    if (singularPos.empty()) return true;
+    for (int i = 0; i < m; i++) if (!pivoted[i]) freeRows.push_back(i);
+    return false;
+}
+
+void BasisFactor::ftran(vector<double>& a) {
+    for (int k = 0; k < m; k++) {
+        double v = a[pivRow[k]];
+        if (v == 0) continue;
+        for (int e = lBeg[k]; e < lBeg[k+1]; e++) a[lInd[e]] -= lVal[e] * v;
+    }
+
+    for (int k = 0; k < m; k++) work[k] = a[pivRow[k]];
+    for (int k = m - 1; k >= 0; k--) {
+        double z = work[k] / uDiag[k];
+        work[k] = z;
+        if (z == 0) continue;
+        for (int e = uBeg[k]; e < uBeg[k+1]; e++) work[uInd[e]] -= uVal[e] * z;
+    }
+    for (int k = 0; k < m; k++) a[pivPos[k]] = work[k];
+
+    for (int t = 0; t < (int)etaPos.size(); t++) {
+        int q = etaPos[t];
+        double xq = a[q] / etaPivot[t];
+        a[q] = xq;
+        if (xq == 0) continue;
+        for (int e = etaBeg[t]; e < etaBeg[t+1]; e++) a[etaInd[e]] -= etaVal[e] * xq;
+    }
+}
+
+void BasisFactor::btran(vector<double>& c) {
+    for (int t = (int)etaPos.size() - 1; t >= 0; t--) {
+        int q = etaPos[t];
+        double s = c[q];
+        for (int e = etaBeg[t]; e < etaBeg[t+1]; e++) s -= etaVal[e] * c[etaInd[e]];
+        c[q] = s / etaPivot[t];
+    }
+
+    for (int k = 0; k < m; k++) work[k] = c[pivPos[k]];
+    for (int k = 0; k < m; k++) {
+        double s = work[k];
+        for (int e = uBeg[k]; e < uBeg[k+1]; e++) s -= uVal[e] * work[uInd[e]];
+        work[k] = s / uDiag[k];
+    }
+    for (int k = 0; k < m; k++) c[pivRow[k]] = work[k];
+
+    for (int k = m - 1; k >= 0; k--) {
+        int r = pivRow[k];
+        double s = c[r];
+        for (int e = lBeg[k]; e < lBeg[k+1]; e++) s -= lVal[e] * c[lInd[e]];
+        c[r] = s;
+    }
+}
+
+void BasisFactor::update(int pos, const vector<double>& alpha) {
+    for (int i = 0; i < m; i++) {
+        if (i == pos || fabs(alpha[i]) <= FACTOR_DROP_TOLERANCE) continue;
+        etaInd.push_back(i);
+        etaVal.push_back(alpha[i]);
+    }
+    etaBeg.push_back((int)etaInd.size());
+    etaPos.push_back(pos);
+    etaPivot.push_back(alpha[pos]);
+}
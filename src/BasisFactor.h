@@ -0,0 +1,81 @@
+/**
+ * BasisFactor.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef BASISFACTOR_H
+#define BASISFACTOR_H
+
+#include "Util.h"
+
+/**
+ * Sparse LU factorisation of a simplex basis, with product form updates.
+ *
+ * B = L U up to permutations. Columns are eliminated in increasing order of
+ * nonzeros (slacks first), pivot rows are chosen by partial pivoting. L is kept
+ * as column etas over the original rows and U by columns in pivot order. After
+ * a basis change the new basis is represented by an additional eta, until the
+ * next factorisation.
+ *
+ * Vectors indexed by row are the right hand side of ftran and the result of
+ * btran, vectors indexed by basis position are the result of ftran and the
+ * right hand side of btran.
+ */
+class BasisFactor {
+
+    private:
+
+        int m;
+
+        // k -> row and basis position of the k-th pivot
+        vector<int> pivRow;
+        vector<int> pivPos;
+
+        vector<int>    lBeg;
+        vector<int>    lInd;
+        vector<double> lVal;
+
+        // U entries of pivot k are (pivot index, value), diagonal apart
+        vector<int>    uBeg;
+        vector<int>    uInd;
+        vector<double> uVal;
+        vector<double> uDiag;
+
+        // Product form updates
+        vector<int>    etaPos;
+        vector<int>    etaBeg;
+        vector<int>    etaInd;
+        vector<double> etaVal;
+        vector<double> etaPivot;
+
+        vector<double> work;
+
+    public:
+
+        BasisFactor();
+        ~BasisFactor();
+
+        /**
+         * Factorises the basis of numRows columns, the one at position p has nonzeros
+         * [beg[p], beg[p+1]) in ind (rows) and val. Returns false if the basis is singular,
+         * in which case singularPos and freeRows have the positions that could not be
+         * pivoted and the rows left without a pivot (same size).
+         */
+        bool factorise(int numRows, const vector<int>& beg, const vector<int>& ind, const vector<double>& val,
+                       vector<int>& singularPos, vector<int>& freeRows);
+
+        // Solves B x = a, a indexed by row in, x indexed by position out
+        void ftran(vector<double>& a);
+        // Solves B^T y = c, c indexed by position in, y indexed by row out
+        void btran(vector<double>& c);
+
+        // The column at position pos was replaced by one whose ftran is alpha
+        void update(int pos, const vector<double>& alpha);
+
+        int getNumUpdates() const { return (int)etaPos.size(); }
+};
+
+#endif
@@ -0,0 +1,514 @@
+/**
+ * BranchAndBound.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "BranchAndBound.h"
+#include "Model.h"
+#include <thread>
+
+#define BB_INFINITY              1e20
+#define BB_INTEGER_TOLERANCE     1e-6
+#define BB_CUT_TOLERANCE         1e-6
+// Every this many nodes a thread takes its best bound node instead of diving, by MIP emphasis
+#define BB_BEST_BOUND_FREQUENCY  8
+#define BB_FEASIBILITY_FREQUENCY 32
+#define BB_OPTIMALITY_FREQUENCY  2
+// Rounds of user cuts at the root and at the other nodes
+#define BB_ROOT_CUT_ROUNDS       20
+#define BB_NODE_CUT_ROUNDS       1
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+BranchAndBound::BranchAndBound() : Simplex() {
+    numThreads     = 1;
+    nodeLimit      = 0;
+    timeLimit      = 0;
+    debug          = 0;
+    bestBoundFrequency = BB_BEST_BOUND_FREQUENCY;
+    seed           = 0;
+    cutBudget      = 0;
+    cutMaxParallelism = 1;
+    lazyData       = NULL;
+    userCutData    = NULL;
+    incumbentData  = NULL;
+    infoData       = NULL;
+    mip            = false;
+    sense          = 1;
+    cutoff         = BB_INFINITY;
+    externalCutoff = BB_INFINITY;
+    terminated     = false;
+    openNodes      = 0;
+    nodeCount      = 0;
+    stop           = false;
+    rootUnbounded  = false;
+    hitTimeLimit   = false;
+    incumbentValue = BB_INFINITY;
+    bestBound      = 0;
+    startTime      = 0;
+    droppedNodes   = 0;
+}
+
+BranchAndBound::~BranchAndBound() {
+}
+
+void BranchAndBound::printSolverName() {
+    printf("Solver used is the built-in branch-and-bound (%d threads)\n", numThreads > 0 ? numThreads : (int)std::thread::hardware_concurrency());
+}
+
+/**
+ * PARAMS
+ *
+ */
+
+void BranchAndBound::setTimeLimit(double time) {
+    timeLimit = time;
+    Simplex::setTimeLimit(time);
+}
+
+// Same meaning as in CPLEX: deterministic (m = 0) runs use a single thread
+void BranchAndBound::setSolverParallelism(int t, int m) {
+    numThreads = m == 0 ? 1 : t;
+}
+
+// 1 (feasibility) and 4 (hidden feasibility) dive more, 2 (optimality) and 3 (best bound) less
+void BranchAndBound::setMIPEmphasis(int t) {
+    if      (t == 1 || t == 4) bestBoundFrequency = BB_FEASIBILITY_FREQUENCY;
+    else if (t == 2 || t == 3) bestBoundFrequency = BB_OPTIMALITY_FREQUENCY;
+    else                       bestBoundFrequency = BB_BEST_BOUND_FREQUENCY;
+}
+
+void BranchAndBound::debugInformation(int d) {
+    debug = d;
+    Simplex::debugInformation(d);
+}
+
+/**
+ * SOLVE
+ *
+ */
+
+void BranchAndBound::doSolve() {
+    if (!isMIP()) {
+        mip = false;
+        Simplex::doSolve();
+        return;
+    }
+
+    mip       = true;
+    startTime = Util::getWallTime();
+    sense     = getProblem().isMaximisation() ? -1 : 1;
+    status    = SIMPLEX_UNSOLVED;
+    cutoff    = externalCutoff.load();
+    openNodes = 0;
+    nodeCount = 0;
+    stop      = false;
+    rootUnbounded  = false;
+    hitTimeLimit   = false;
+    droppedNodes   = 0;
+    incumbentValue = BB_INFINITY;
+    incumbent.clear();
+    cutPool.clear();
+
+    int threads = numThreads > 0 ? numThreads : (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+
+    workers.clear();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back(new Worker());
+        Worker& w = *workers.back();
+        w.lp.setNamesEnabled(false);
+        w.lp.loadModel(getProblem());
+        w.lp.relax();
+        w.lp.setTimeLimit(timeLimit);
+        w.lp.setIterationLimit(getMaxIterations());
+        w.cutsAdded = 0;
+        w.taken     = 0;
+        w.droppedBound = BB_INFINITY;
+    }
+
+    BBNode root;
+    root.bound = -BB_INFINITY;
+    root.depth = 0;
+    pushNode(0, root);
+
+    if (threads == 1) {
+        work(0);
+    } else {
+        vector<std::thread> pool;
+        for (int t = 0; t < threads; t++) pool.emplace_back(&BranchAndBound::work, this, t);
+        for (auto& th : pool) th.join();
+    }
+
+    // Bound of what was left open, dropped nodes were not explored either
+    double remaining = BB_INFINITY;
+    int    numOpen   = 0;
+    for (auto& w : workers) {
+        for (const BBNode& node : w->nodes) remaining = std::min(remaining, node.bound);
+        remaining = std::min(remaining, w->droppedBound);
+        numOpen += (int)w->nodes.size();
+    }
+    bool hasIncumbent = !incumbent.empty();
+
+    if (rootUnbounded) {
+        status = BB_UNBOUNDED;
+    } else if (numOpen > 0) {
+        if (hitTimeLimit) status = hasIncumbent ? BB_TIME_LIMIT_FEASIBLE : BB_TIME_LIMIT_INFEASIBLE;
+        else              status = hasIncumbent ? BB_NODE_LIMIT_FEASIBLE : BB_NODE_LIMIT_INFEASIBLE;
+    } else if (droppedNodes > 0) {
+        status = hasIncumbent ? BB_DROPPED_NODES_FEASIBLE : BB_DROPPED_NODES_INFEASIBLE;
+    } else {
+        status = hasIncumbent ? BB_OPTIMAL : BB_INFEASIBLE;
+    }
+    // The cutoff may have been given by setCutoff
+    bestBound = sense * std::min(remaining, cutoff.load());
+    terminated = false;
+
+    if (debug > 1) {
+        printf("Branch-and-bound: %d nodes on %d threads in %.3fs, %d cuts, status = %d, incumbent = %.6f, bound = %.6f\n",
+               nodeCount.load(), threads, Util::getWallTime() - startTime, cutPool.getNumRows(), status,
+               hasIncumbent ? sense * incumbentValue : 0.0, bestBound);
+        if (droppedNodes > 0) printf("Branch-and-bound: %d nodes dropped due to numerical difficulties\n", droppedNodes.load());
+    }
+    workers.clear();
+}
+
+void BranchAndBound::work(int id) {
+    BBNode node;
+    while (!stop) {
+        if (terminated) {
+            stop = true;
+            break;
+        }
+        if (!takeNode(id, node)) {
+            if (openNodes == 0) break;
+            std::this_thread::yield();
+            continue;
+        }
+
+        bool overNodes = nodeLimit > 0 && nodeCount >= nodeLimit;
+        bool overTime  = timeLimit > 0 && Util::getWallTime() - startTime > timeLimit;
+        if (overNodes || overTime) {
+            if (overTime) hitTimeLimit = true;
+            stop = true;
+            // Kept open so that the bound accounts for it
+            std::lock_guard<std::mutex> guard(workers[id]->lock);
+            workers[id]->nodes.push_back(node);
+            break;
+        }
+
+        if (!pruned(node.bound)) {
+            processNode(id, node);
+            int count = ++nodeCount;
+            if (listener) listener->newNodeCount(this, count);
+        }
+        openNodes--;
+    }
+}
+
+/**
+ * Own nodes first, the last pushed one (diving) or now and then the best bound one.
+ * Otherwise the oldest node of some other thread, which tends to be close to the root.
+ */
+bool BranchAndBound::takeNode(int id, BBNode& node) {
+    Worker& w = *workers[id];
+    {
+        std::lock_guard<std::mutex> guard(w.lock);
+        if (!w.nodes.empty()) {
+            auto it = w.nodes.end() - 1;
+            if (++w.taken % bestBoundFrequency == 0) {
+                it = std::min_element(w.nodes.begin(), w.nodes.end(),
+                                      [](const BBNode& a, const BBNode& b) { return a.bound < b.bound; });
+            }
+            node = std::move(*it);
+            w.nodes.erase(it);
+            return true;
+        }
+    }
+
+    int numWorkers = (int)workers.size();
+    for (int k = 1; k < numWorkers; k++) {
+        Worker& victim = *workers[(id + k) % numWorkers];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.nodes.empty()) continue;
+        node = std::move(victim.nodes.front());
+        victim.nodes.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void BranchAndBound::pushNode(int id, BBNode& node) {
+    openNodes++;
+    std::lock_guard<std::mutex> guard(workers[id]->lock);
+    workers[id]->nodes.push_back(std::move(node));
+}
+
+bool BranchAndBound::pruned(double bound) {
+    double limit = cutoff;
+    return bound >= limit - BB_INTEGER_TOLERANCE * std::max(1.0, fabs(limit));
+}
+
+/**
+ * Solves the node LP, separating lazy constraints on integral solutions and user cuts on
+ * fractional ones, then either updates the incumbent or branches on the most fractional column.
+ */
+void BranchAndBound::processNode(int id, BBNode& node) {
+    Worker& w = *workers[id];
+    const char* types = getProblem().getTypes();
+    int numCols = getProblem().getNumCols();
+    applyBounds(w, node);
+
+    vector<double>& x = w.x;
+    double value  = 0;
+    int    branch = -1;
+    int    rounds = 0;
+    while (true) {
+        syncCuts(w);
+        w.lp.doSolve();
+        if (w.lp.isInfeasible()) return;
+        if (w.lp.isUnbounded()) {
+            if (node.depth == 0) {
+                rootUnbounded = true;
+                stop = true;
+            }
+            return;
+        }
+        if (!w.lp.isOptimal()) {
+            if (w.lp.isTimeLimit()) {
+                hitTimeLimit = true;
+                stop = true;
+                std::lock_guard<std::mutex> guard(w.lock);
+                w.nodes.push_back(node);
+                openNodes++;
+            } else {
+                droppedNodes++;
+                w.droppedBound = std::min(w.droppedBound, node.bound);
+            }
+            return;
+        }
+
+        value = sense * w.lp.getObjValue();
+        if (pruned(value)) return;
+
+        w.lp.getColSolution();
+        const double* sol = w.lp.getColValues();
+        x.assign(sol, sol + numCols);
+
+        branch = -1;
+        double mostFractional = BB_INTEGER_TOLERANCE;
+        for (int j = 0; j < numCols; j++) {
+            if (types[j] == 'C') continue;
+            double f = fabs(x[j] - floor(x[j] + 0.5));
+            // A seed breaks ties (and near ties) differently
+            if (seed && f > BB_INTEGER_TOLERANCE) f *= 1 + 0.1 * (((unsigned)j * 2654435761u + (unsigned)seed) % 1024) / 1024.0;
+            if (f > mostFractional) {
+                mostFractional = f;
+                branch = j;
+            }
+        }
+
+        if (branch == -1) {
+            if (lazyData && separate(w, lazyData, &x[0], false)) continue;
+            updateIncumbent(value, &x[0]);
+            break;
+        }
+
+        int maxRounds = node.depth == 0 ? BB_ROOT_CUT_ROUNDS : BB_NODE_CUT_ROUNDS;
+        if (userCutData && rounds++ < maxRounds && separate(w, userCutData, &x[0], true)) continue;
+        break;
+    }
+
+    if (node.depth == 0 && listener) listener->newBound(this, sense * value);
+    if (node.depth == 0 && infoData) {
+        Model* model = static_cast<Model*>(infoData);
+        model->firstNodeBoundCallbackFunction(sense * value);
+    }
+    if (branch == -1) return;
+
+    BBNode down;
+    down.bound = value;
+    down.depth = node.depth + 1;
+    down.cols  = node.cols;
+    down.lower = node.lower;
+    down.upper = node.upper;
+    BBNode up = down;
+
+    // Bounds of the branching column at this node
+    double lower = getProblem().getLower()[branch];
+    double upper = getProblem().getUpper()[branch];
+    for (unsigned k = 0; k < node.cols.size(); k++) {
+        if (node.cols[k] != branch) continue;
+        lower = node.lower[k];
+        upper = node.upper[k];
+    }
+
+    double v = x[branch];
+    down.cols.push_back(branch);
+    down.lower.push_back(lower);
+    down.upper.push_back(floor(v));
+    up.cols.push_back(branch);
+    up.lower.push_back(ceil(v));
+    up.upper.push_back(upper);
+
+    // The child on the side the LP leans to is pushed last, so it is the one dived into
+    if (v - floor(v) < 0.5) {
+        pushNode(id, up);
+        pushNode(id, down);
+    } else {
+        pushNode(id, down);
+        pushNode(id, up);
+    }
+}
+
+// Undoes the bound changes of the previous node of this thread and applies the ones of node
+void BranchAndBound::applyBounds(Worker& w, const BBNode& node) {
+    const double* lower = getProblem().getLower();
+    const double* upper = getProblem().getUpper();
+    for (int col : w.changedCols) w.lp.setColBounds(col, lower[col], upper[col]);
+    for (unsigned k = 0; k < node.cols.size(); k++) w.lp.setColBounds(node.cols[k], node.lower[k], node.upper[k]);
+    w.changedCols = node.cols;
+}
+
+void BranchAndBound::syncCuts(Worker& w) {
+    std::lock_guard<std::mutex> guard(cutLock);
+    const int*    ind = cutPool.getRowInd();
+    const double* val = cutPool.getRowVal();
+    for (int r = w.cutsAdded; r < cutPool.getNumRows(); r++) {
+        int beg = cutPool.getRowBegin(r);
+        w.lp.addRow(cutPool.getRowEnd(r) - beg, ind + beg, val + beg, cutPool.getRhs()[r], cutPool.getSense()[r]);
+    }
+    w.cutsAdded = cutPool.getNumRows();
+}
+
+/**
+ * Calls the separation of the model, as CPLEX::functionCallback does, and adds the cuts violated
+ * by x to the pool. User cuts go through the cut selection first. Cuts stay in the pool, so purgeable
+ * cuts are added like forced ones and those CPLEX would filter are left out. Returns whether any was added.
+ */
+bool BranchAndBound::separate(Worker& w, void* userData, const double* x, bool userCuts) {
+    Model* model = static_cast<Model*>(userData);
+    w.cuts.clear();
+    model->separate(Span<double>(x, getProblem().getNumCols()), w.cuts);
+
+    if (userCuts) {
+        w.selector.select(w.cuts, x, BB_CUT_TOLERANCE, cutBudget, cutMaxParallelism, w.decisions);
+    } else {
+        w.cuts.getViolations(x, w.violations);
+        w.decisions.resize(w.cuts.getNumCuts());
+        for (int i = 0; i < w.cuts.getNumCuts(); i++) w.decisions[i] = w.violations[i] > BB_CUT_TOLERANCE ? CUT_FORCED : CUT_DROPPED;
+    }
+
+    int added = 0;
+    std::lock_guard<std::mutex> guard(cutLock);
+    for (int i = 0; i < w.cuts.getNumCuts(); i++) {
+        if (w.decisions[i] == CUT_DROPPED || w.decisions[i] == CUT_FILTERED) continue;
+
+        int beg = w.cuts.getBegin(i);
+        cutPool.addRow(w.cuts.getEnd(i) - beg, w.cuts.getRowInd() + beg, w.cuts.getRowVal() + beg, w.cuts.getRhs()[i], w.cuts.getSense()[i]);
+        added++;
+    }
+    return added > 0;
+}
+
+void BranchAndBound::updateIncumbent(double value, const double* x) {
+    {
+        std::lock_guard<std::mutex> guard(incumbentLock);
+        if (value >= incumbentValue) return;
+        incumbentValue = value;
+        incumbent.assign(x, x + getProblem().getNumCols());
+        lowerCutoff(value);
+    }
+
+    if (listener) listener->newIncumbent(this, sense * value);
+    if (incumbentData) {
+        Model* model = static_cast<Model*>(incumbentData);
+        model->incumbentFound(sense * value, x);
+    }
+    if (infoData) {
+        Model* model = static_cast<Model*>(infoData);
+        model->bestSolutionValueCallbackFunction(sense * value);
+    }
+}
+
+// Other threads may lower it at the same time
+void BranchAndBound::lowerCutoff(double value) {
+    double current = cutoff;
+    while (value < current && !cutoff.compare_exchange_weak(current, value));
+}
+
+// Nodes whose bound is not better than value are pruned, from now on and in later solves
+void BranchAndBound::setCutoff(double value) {
+    double v = getProblem().isMaximisation() ? -value : value;
+    double current = externalCutoff;
+    while (v < current && !externalCutoff.compare_exchange_weak(current, v));
+    lowerCutoff(v);
+}
+
+/**
+ * GET DATA
+ *
+ */
+
+double BranchAndBound::getObjValue() {
+    if (!mip) return Simplex::getObjValue();
+    return incumbent.empty() ? 0 : sense * incumbentValue;
+}
+
+double BranchAndBound::getBestBound() {
+    return mip ? bestBound : Simplex::getBestBound();
+}
+
+void BranchAndBound::getColSolution() {
+    if (!mip) Simplex::getColSolution();
+    else      colSolution = incumbent;
+}
+
+/**
+ * STATUS
+ *
+ */
+
+bool BranchAndBound::solutionExists() {
+    return mip ? !incumbent.empty() : Simplex::solutionExists();
+}
+
+bool BranchAndBound::isOptimal() {
+    return mip ? status == BB_OPTIMAL : Simplex::isOptimal();
+}
+
+bool BranchAndBound::isIntegerOptimal() {
+    return mip && status == BB_OPTIMAL;
+}
+
+bool BranchAndBound::isInfeasible() {
+    return mip ? status == BB_INFEASIBLE : Simplex::isInfeasible();
+}
+
+bool BranchAndBound::isUnbounded() {
+    return mip ? status == BB_UNBOUNDED : Simplex::isUnbounded();
+}
+
+bool BranchAndBound::isTimeLimit() {
+    if (!mip) return Simplex::isTimeLimit();
+    return status == BB_TIME_LIMIT_FEASIBLE || status == BB_TIME_LIMIT_INFEASIBLE;
+}
+
+bool BranchAndBound::isMIPTimeLimitFeasible() {
+    return mip && status == BB_TIME_LIMIT_FEASIBLE;
+}
+
+bool BranchAndBound::isMIPTimeLimitInfeasible() {
+    return mip && status == BB_TIME_LIMIT_INFEASIBLE;
+}
+
+bool BranchAndBound::isNumericalDifficulties() {
+    if (!mip) return Simplex::isNumericalDifficulties();
+    return status == BB_DROPPED_NODES_FEASIBLE || status == BB_DROPPED_NODES_INFEASIBLE;
+}
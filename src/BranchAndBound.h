@@ -0,0 +1,171 @@
+/**
+ * BranchAndBound.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef BRANCHANDBOUND_H
+#define BRANCHANDBOUND_H
+
+#include "Simplex.h"
+#include "CutBuffer.h"
+#include "CutSelector.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+enum BranchAndBoundStatus {
+    BB_OPTIMAL = 101,
+    BB_INFEASIBLE,
+    BB_UNBOUNDED,
+    BB_TIME_LIMIT_FEASIBLE,
+    BB_TIME_LIMIT_INFEASIBLE,
+    BB_NODE_LIMIT_FEASIBLE,
+    BB_NODE_LIMIT_INFEASIBLE,
+    // Some node LPs stopped on the iteration limit or numerical difficulties, the tree was not closed
+    BB_DROPPED_NODES_FEASIBLE,
+    BB_DROPPED_NODES_INFEASIBLE
+};
+
+// Bound changes from the root, later changes override earlier ones
+struct BBNode {
+    double bound;
+    int depth;
+    vector<int>    cols;
+    vector<double> lower;
+    vector<double> upper;
+};
+
+/**
+ * Built-in MIP solver, parallel branch-and-bound on top of the simplex.
+ *
+ * Every thread has its own simplex (warm started from the last node it solved) and
+ * its own deque of open nodes. A thread dives by taking the last node pushed, and
+ * every few nodes takes the best bound one instead. Threads without nodes steal the
+ * oldest node of another thread.
+ *
+ * Lazy constraint, user cut, incumbent and info callbacks call the model as CPLEX
+ * does, through Model::separate and Model::incumbentFound. Each thread separates into its own
+ * CutBuffer. Cuts are global: they are added to every thread's LP.
+ * LPs are solved by the simplex directly.
+ */
+class BranchAndBound : public Simplex {
+
+    private:
+
+        struct Worker {
+            std::mutex    lock;
+            std::deque<BBNode> nodes;
+            Simplex       lp;
+            vector<int>   changedCols;
+            int           cutsAdded;
+            int           taken;
+            // Lowest bound of the nodes whose LP could not be solved
+            double        droppedBound;
+            // Reused from node to node
+            vector<double> x;
+            CutBuffer     cuts;
+            vector<double> violations;
+            CutSelector   selector;
+            vector<char>  decisions;
+        };
+
+        vector<std::unique_ptr<Worker>> workers;
+
+        // Parameters
+        int numThreads;
+        int nodeLimit;
+        double timeLimit;
+        int debug;
+        int bestBoundFrequency;
+        int seed;
+        int    cutBudget;
+        double cutMaxParallelism;
+
+        // Callbacks
+        void* lazyData;
+        void* userCutData;
+        void* incumbentData;
+        void* infoData;
+
+        // Shared state
+        bool mip;
+        double sense;
+        std::mutex incumbentLock;
+        std::mutex cutLock;
+        std::atomic<double> cutoff;
+        // Given by setCutoff, kept for the next solve
+        std::atomic<double> externalCutoff;
+        std::atomic<bool> terminated;
+        std::atomic<int>  openNodes;
+        std::atomic<int>  nodeCount;
+        std::atomic<bool> stop;
+        std::atomic<bool> rootUnbounded;
+        std::atomic<bool> hitTimeLimit;
+        vector<double> incumbent;
+        double incumbentValue;
+        double bestBound;
+        ModelIR cutPool;
+        double startTime;
+        std::atomic<int>  droppedNodes;
+
+        void work(int id);
+        bool takeNode(int id, BBNode& node);
+        void pushNode(int id, BBNode& node);
+        void processNode(int id, BBNode& node);
+        void applyBounds(Worker& w, const BBNode& node);
+        void syncCuts(Worker& w);
+        bool separate(Worker& w, void* userData, const double* x, bool userCuts);
+        void updateIncumbent(double value, const double* x);
+        void lowerCutoff(double value);
+        bool pruned(double bound);
+
+    public:
+
+        BranchAndBound();
+        virtual ~BranchAndBound();
+
+        virtual void doSolve();
+        virtual void setCutoff(double value);
+        virtual void terminate() { terminated = true; }
+
+        // Get data
+        virtual double getObjValue();
+        virtual double getBestBound();
+        virtual void getColSolution();
+        virtual int getNodeCount() { return mip ? nodeCount.load() : 0; }
+
+        // Params
+        virtual void setTimeLimit(double time);
+        virtual void setNodeLimit(int lim) { nodeLimit = lim; }
+        virtual void setSolverParallelism(int t, int m);
+        virtual void setMIPEmphasis(int t);
+        virtual void setSolverRandomSeed(int s) { seed = s; }
+        virtual void setCutSelection(int budget, double maxParallelism) { cutBudget = budget; cutMaxParallelism = maxParallelism; }
+
+        // Debug
+        virtual void printSolverName();
+        virtual void debugInformation(int d);
+
+        // Status
+        virtual bool solutionExists();
+        virtual bool isOptimal();
+        virtual bool isIntegerOptimal();
+        virtual bool isInfeasible();
+        virtual bool isUnbounded();
+        virtual bool isTimeLimit();
+        virtual bool isMIPTimeLimitFeasible();
+        virtual bool isMIPTimeLimitInfeasible();
+        virtual bool isNumericalDifficulties();
+
+        // Callbacks
+        virtual void addLazyCallback     (void* userData) { lazyData      = userData; }
+        virtual void addUserCutCallback  (void* userData) { userCutData   = userData; }
+        virtual void addIncumbentCallback(void* userData) { incumbentData = userData; }
+        virtual void addInfoCallback     (void* userData) { infoData      = userData; }
+};
+
+#endif
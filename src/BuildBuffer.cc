@@ -0,0 +1,67 @@
+/**
+ * BuildBuffer.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "BuildBuffer.h"
+
+BuildBuffer::BuildBuffer() {
+    nameBytes = 0;
+}
+
+BuildBuffer::~BuildBuffer() {
+}
+
+void BuildBuffer::addColumns(int numCols, const double* objs, const double* lower, const double* upper, char type) {
+    obj.insert(obj.end(), objs,  objs  + numCols);
+    lb .insert(lb .end(), lower, lower + numCols);
+    ub .insert(ub .end(), upper, upper + numCols);
+    types.resize(types.size() + numCols, type);
+}
+
+void BuildBuffer::addRow(int numNonZero, const int* colIndices, const double* elements, double r, char s) {
+    rowBeg.push_back((int)rowInd.size());
+    rowInd.insert(rowInd.end(), colIndices, colIndices + numNonZero);
+    rowVal.insert(rowVal.end(), elements,   elements   + numNonZero);
+    rhs.push_back(r);
+    sense.push_back(s);
+}
+
+void BuildBuffer::addColName(int col, const string& name) {
+    namedCols.push_back(col);
+    colNames.push_back(name);
+    nameBytes += name.size() + sizeof(string) + sizeof(int);
+}
+
+void BuildBuffer::addRowName(int row, const string& name) {
+    namedRows.push_back(row);
+    rowNames.push_back(name);
+    nameBytes += name.size() + sizeof(string) + sizeof(int);
+}
+
+void BuildBuffer::clear() {
+    obj.clear();
+    lb.clear();
+    ub.clear();
+    types.clear();
+    rhs.clear();
+    sense.clear();
+    rowBeg.clear();
+    rowInd.clear();
+    rowVal.clear();
+    namedCols.clear();
+    colNames.clear();
+    namedRows.clear();
+    rowNames.clear();
+    nameBytes = 0;
+}
+
+size_t BuildBuffer::getMemoryUsage() const {
+    return obj.size()    * (3 * sizeof(double) + sizeof(char)) +
+           rhs.size()    * (sizeof(double) + sizeof(char) + sizeof(int)) +
+           rowInd.size() * (sizeof(int) + sizeof(double)) + 
+           nameBytes;
+}
@@ -0,0 +1,80 @@
+/**
+ * BuildBuffer.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef BUILDBUFFER_H
+#define BUILDBUFFER_H
+
+#include "Util.h"
+
+/**
+ * Columns and rows waiting to be passed to a solver in bulk.
+ *
+ * Rows are stored in CSR form (rowBeg, rowInd, rowVal). Names are stored
+ * only for the columns and rows that have one, with their final indices.
+ */
+class BuildBuffer {
+
+    private:
+
+        // Columns
+        vector<double> obj;
+        vector<double> lb;
+        vector<double> ub;
+        vector<char>   types;
+
+        // Rows
+        vector<double> rhs;
+        vector<char>   sense;
+        vector<int>    rowBeg;
+        vector<int>    rowInd;
+        vector<double> rowVal;
+
+        // Names
+        vector<int>    namedCols;
+        vector<string> colNames;
+        vector<int>    namedRows;
+        vector<string> rowNames;
+
+        size_t nameBytes;
+
+    public:
+
+        BuildBuffer();
+        ~BuildBuffer();
+
+        // type: 'C' continuous, 'B' binary or 'I' integer
+        void addColumns(int numCols, const double* objs, const double* lower, const double* upper, char type);
+        void addRow(int numNonZero, const int* colIndices, const double* elements, double r, char s);
+        void addColName(int col, const string& name);
+        void addRowName(int row, const string& name);
+        void setBounds(int col, double lower, double upper) { lb[col] = lower; ub[col] = upper; }
+        void clear();
+
+        int    getNumCols()      const { return (int)obj.size();    }
+        int    getNumRows()      const { return (int)rhs.size();    }
+        int    getNumNonZeros()  const { return (int)rowInd.size(); }
+        bool   isEmpty()         const { return obj.empty() && rhs.empty(); }
+        size_t getMemoryUsage()  const;
+
+        const double* getObj()      const { return obj.data();    }
+        const double* getLower()    const { return lb.data();     }
+        const double* getUpper()    const { return ub.data();     }
+        const char*   getTypes()    const { return types.data();  }
+        const double* getRhs()      const { return rhs.data();    }
+        const char*   getSense()    const { return sense.data();  }
+        const int*    getRowBeg()   const { return rowBeg.data(); }
+        const int*    getRowInd()   const { return rowInd.data(); }
+        const double* getRowVal()   const { return rowVal.data(); }
+
+        const vector<int>&    getNamedCols() const { return namedCols; }
+        const vector<string>& getColNames()  const { return colNames;  }
+        const vector<int>&    getNamedRows() const { return namedRows; }
+        const vector<string>& getRowNames()  const { return rowNames;  }
+};
+
+#endif
@@ -7,15 +7,21 @@
  */
 
 #include "CPLEX.h"
+#include "CPLEXEnvPool.h"
 #include "Model.h"
+#include "CutBuffer.h"
+#include "CutSelector.h"
+#include <mutex>
 
+// Relative, nodes are pruned and the solve is stopped once their bound is within it from the cutoff
+#define CUTOFF_TOLERANCE 1e-9
+// Cuts not violated by more than this are not added
+#define CUT_TOLERANCE    1e-6
+
+// The environment is not closed, it belongs to the pool and is released by the destructor
 inline void Check(int result, CPXENVptr env = NULL) {
     if (result != 0) {
         printf("Result = %d\n", result);
-        if ( env != NULL ) {
-            CPXcloseCPLEX (&env);
-        }
-
         throw SolverError(result);
     }
 }
@@ -28,27 +34,48 @@ inline void Check(int result, CPXENVptr env = NULL) {
 
 
 CPLEX::CPLEX() : Solver() {
-    int status = 0;
-    env = CPXopenCPLEX(&status);
-    Check(status, env);
+    building = false;
+    maxBufferBytes = 0;
+    lazyData      = NULL;
+    userCutData   = NULL;
+    incumbentData = NULL;
+    infoData      = NULL;
+    nodeData      = NULL;
+    solveData     = NULL;
+    numCols       = 0;
+    cutBudget     = 0;
+    cutMaxParallelism = 1;
+    terminateFlag = 0;
+    objSense = CPX_MIN;
+    hasCutoff = false;
+    cutoff = 0;
+
+    // Environments are leased, only the problem is created here
+    env = CPLEXEnvPool::getInstance()->acquire();
     
-    status = 0;
+    int status = 0;
     problem = CPXcreateprob(env, &status, "");
+    if (status == 0) status = CPXsetterminate(env, &terminateFlag);
+    if (status != 0) CPLEXEnvPool::getInstance()->release(env);
     Check(status, env);
 }
 
 CPLEX::~CPLEX() {
-    if (env != NULL) CPXcloseCPLEX(&env);
+    if (problem != NULL) CPXfreeprob(env, &problem);
+    CPLEXEnvPool::getInstance()->release(env);
 }
 
 void CPLEX::deleteAndRecreateProblem() {
     Check(CPXfreeprob(env, &problem));
+    clearKeys();
+    buffer.clear();
     status = 0;
     problem = CPXcreateprob(env, &status, "");
     Check(status, env);
 }
 
 void CPLEX::readProblem(string filename) {
+    buffer.clear();
     Check(CPXfreeprob(env, &problem));
     printf("Filename: %s\n", filename.c_str());
     status = CPXreadcopyprob(env, problem, filename.c_str(), NULL);    
@@ -60,16 +87,18 @@ void CPLEX::printSolverName() {
 }
 
 int CPLEX::isMIP() {
+    flushBuild();
     int type = CPXgetprobtype(env, problem);
     return type == CPXPROB_MILP;
 }
 
+// Include those still in the build buffer
 int CPLEX::getNumRows() { 
-    return CPXgetnumrows(env, problem); 
+    return CPXgetnumrows(env, problem) + buffer.getNumRows(); 
 }
 
 int CPLEX::getNumCols() { 
-    return CPXgetnumcols(env, problem); 
+    return CPXgetnumcols(env, problem) + buffer.getNumCols(); 
 }
 
 void CPLEX::changeObjectiveSense(bool isMax) {
@@ -81,35 +110,136 @@ int CPLEX::getNodeCount() {
     return CPXgetnodecnt(env, problem); 
 }
 
+/**
+ * If names are disabled the name is only stored in the map and passed to CPLEX when needed
+ */
+void CPLEX::nameColumn(int col, const string& name) {
+    if (name.empty()) return;
+    if (useNames) {
+        if (building) buffer.addColName(col, name);
+        else          Check(CPXchgname(env, problem, 'c', col, name.c_str()), env);
+    }
+    addKey(name, col);
+}
+
+void CPLEX::writeColNames(const vector<int>& indices, const vector<string>& names) {
+    flushBuild();
+    vector<char*> n(names.size());
+    for (unsigned i = 0; i < names.size(); i++) n[i] = const_cast<char*>(names[i].c_str());
+    Check(CPXchgcolname(env, problem, (int)indices.size(), &indices[0], &n[0]), env);
+}
+
+void CPLEX::writeRowNames(const vector<int>& indices, const vector<string>& names) {
+    flushBuild();
+    vector<char*> n(names.size());
+    for (unsigned i = 0; i < names.size(); i++) n[i] = const_cast<char*>(names[i].c_str());
+    Check(CPXchgrowname(env, problem, (int)indices.size(), &indices[0], &n[0]), env);
+}
+
+
+/**
+ * Adds columns of a given type (CPX_CONTINUOUS, CPX_BINARY or CPX_INTEGER), directly or,
+ * during a build, to the build buffer. Returns the index of the first column.
+ */
+int CPLEX::addColumns(int numCols, const double* obj, const double* lower, const double* upper, char type) {
+    int firstCol = getNumCols();
+    if (building) {
+        buffer.addColumns(numCols, obj, lower, upper, type);
+        if (buffer.getMemoryUsage() >= maxBufferBytes) flushBuild();
+        return firstCol;
+    }
+
+    Check(CPXaddcols(env, problem, numCols, 0, obj, 0, 0, 0, lower, upper, 0), env);
+    if (type != CPX_CONTINUOUS) {
+        vector<int>  indices(numCols);
+        vector<char> types(numCols, type);
+        for (int i = 0; i < numCols; i++) indices[i] = firstCol + i;
+        Check(CPXchgctype(env, problem, numCols, &indices[0], &types[0]), env);
+    }
+    return firstCol;
+}
+
+/**
+ * Columns and rows added between beginBuild and endBuild are buffered and passed 
+ * to CPLEX in bulk, whenever the buffer reaches maxBytes and at endBuild
+ */
+void CPLEX::beginBuild(size_t maxBytes) {
+    building = true;
+    maxBufferBytes = maxBytes;
+}
+
+void CPLEX::endBuild() {
+    flushBuild();
+    building = false;
+}
+
+/**
+ * Adds the columns and then the rows of b with one call each (plus one to set column types)
+ */
+void CPLEX::addBulk(const BuildBuffer& b) {
+    int numCols = b.getNumCols();
+    if (numCols > 0) {
+        int firstCol = CPXgetnumcols(env, problem);
+        Check(CPXaddcols(env, problem, numCols, 0, b.getObj(), 0, 0, 0, b.getLower(), b.getUpper(), 0), env);
+
+        vector<int>  indices;
+        vector<char> types;
+        for (int i = 0; i < numCols; i++) {
+            if (b.getTypes()[i] == CPX_CONTINUOUS) continue;
+            indices.push_back(firstCol + i);
+            types.push_back(b.getTypes()[i]);
+        }
+        if (!indices.empty()) Check(CPXchgctype(env, problem, (int)indices.size(), &indices[0], &types[0]), env);
+    }
+
+    int numRows = b.getNumRows();
+    if (numRows > 0) {
+        Check(CPXaddrows(env, problem, 0, numRows, b.getNumNonZeros(), b.getRhs(), b.getSense(), 
+                         b.getRowBeg(), b.getRowInd(), b.getRowVal(), 0, 0), env);
+    }
+}
+
+void CPLEX::loadModel(const ModelIR& ir) {
+    flushBuild();
+    if (getNumCols() > 0 || getNumRows() > 0) Util::throwInvalidArgument("Error: A model can only be loaded into an empty problem.");
+
+    changeObjectiveSense(ir.isMaximisation());
+    addBulk(ir);
+    loadNames(ir);
+}
+
+void CPLEX::flushBuild() {
+    if (buffer.isEmpty()) return;
+    
+    addBulk(buffer);
+    
+    // Names are written after the buffer is cleared, writeColNames and writeRowNames flush the build
+    vector<int>    namedCols = buffer.getNamedCols();
+    vector<string> colNames  = buffer.getColNames();
+    vector<int>    namedRows = buffer.getNamedRows();
+    vector<string> rowNames  = buffer.getRowNames();
+    buffer.clear();
+
+    if (!namedCols.empty()) writeColNames(namedCols, colNames);
+    if (!namedRows.empty()) writeRowNames(namedRows, rowNames);
+}
 
 /**
  * lower      -> lower bound of variable
  * upper      -> upper bound of variable
  * obj        -> objective function coefficient
  * name       -> if not empty set the variable name
+ *
+ * Returns the index of the new column
  */
-void CPLEX::addVariable(const double lower, const double upper, const double obj, string name) {
-    double up[1];
-    double lo[1];
-    up[0] = upper;
-    lo[0] = lower;
-
-    Check(CPXaddcols(env, problem, 1, 0, &obj, 0, 0, 0, lo, up, 0), env);
-    //Check(CPXaddcols(env, problem, 1, 0, &obj, 0, 0, 0, &lower, &upper, 0));
-
-    if (!name.empty()) {
-       int col = getNumCols() - 1;
-       Check(CPXchgname(env, problem, 'c', col, name.c_str()), env);
-       
-       //char* n;
-       //n = const_cast<char*>(name.c_str());
-       //Check(CPXchgcolname(env, problem, 1, &col, &n));
-       
-       addKey(name, col);
-    }
+int CPLEX::addVariable(const double lower, const double upper, const double obj, string name) {
+    int col = addColumns(1, &obj, &lower, &upper, CPX_CONTINUOUS);
+    nameColumn(col, name);
+    return col;
 }
 
 void CPLEX::setVariableWarmStart(string colName, double value) {
+    flushBuild();
     int index = getColIndex(colName);
     
     int beg[1]; beg[0] = 0;
@@ -119,6 +249,7 @@ void CPLEX::setVariableWarmStart(string colName, double value) {
 }
 
 void CPLEX::setVariablesWarmStart(vector<string> colNames, vector<double> values) {
+    flushBuild();
     int num = colNames.size();
 
     vector<int> colIndices(num);
@@ -130,6 +261,7 @@ void CPLEX::setVariablesWarmStart(vector<string> colNames, vector<double> values
 }
 
 void CPLEX::refineMIPStart() {
+    flushBuild();
     /*int a1;
     int a2;
     Check(CPXrefinemipstartconflict(env, problem, 0, &a1, &a2));
@@ -146,27 +278,17 @@ void CPLEX::refineMIPStart() {
  * upper      -> array of size (numCols), upper bound of variables
  * obj        -> Array of size (numCols), objective function coefficients
  * name       -> if not empty set the variable name (includes index in the end starting from zero)
+ *
+ * Returns the index of the first new column, the others follow contiguously
  */
 
-void CPLEX::addVariables(int numCols, const double lower, const double upper, const double* obj, string& name) {
-    vector<double> lo(numCols);
-    vector<double> up(numCols);
-    for (int i = 0; i < numCols; i++) {
-        lo[i] = lower;
-        up[i] = upper;
-    }
-
-    Check(CPXaddcols(env, problem, numCols, 0, obj, 0, 0, 0, &lo[0], &up[0], 0), env);    
-    if (!name.empty()) {
-        int col = getNumCols() - numCols;
-        for (int i = 0; i < numCols; i++) {
-            string n = name + lex(i);
-            Check(CPXchgname(env, problem, 'c', col, n.c_str()), env);
-            addKey(n, col);
-            col++;
-        }
-    }
+int CPLEX::addVariables(int numCols, const double lower, const double upper, const double* obj, string& name) {
+    vector<double> lo(numCols, lower);
+    vector<double> up(numCols, upper);
 
+    int firstCol = addColumns(numCols, obj, &lo[0], &up[0], CPX_CONTINUOUS);
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
 }
 
 /**
@@ -175,66 +297,39 @@ void CPLEX::addVariables(int numCols, const double lower, const double upper, co
  * lb         -> lower bound of all variables
  * obj        -> Array of size (numCols), objective function coefficients
  * name       -> if not empty set the variable name (includes index in the end starting from zero)
+ *
+ * Returns the index of the first new column, the others follow contiguously
  */
-void CPLEX::addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name) {
+int CPLEX::addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name) {
  
-    vector<double> upper(numCols);
-    vector<double> lower(numCols);
-    for (int i = 0; i < numCols; i++) {
-        upper[i] = ub;
-        lower[i] = lb;
-    }
-    Check(CPXaddcols(env, problem, numCols, 0, obj, 0, 0, 0, &lower[0], &upper[0], 0), env);
-
-    vector<int> indices(numCols);
-    vector<char> type(numCols);
-    int currentCol = getNumCols() - numCols;
-
-    for (int i = 0; i < numCols; i++) {
-        indices[i] = currentCol;
-        type[i] = CPX_INTEGER;
-        string n = name + lex(i);
-        Check(CPXchgname(env, problem, 'c', currentCol, n.c_str()), env);
-        addKey(n, currentCol);
-        currentCol++;
-    }
-    Check(CPXchgctype(env, problem, numCols, &indices[0], &type[0]), env);
-    
-}
+    vector<double> upper(numCols, ub);
+    vector<double> lower(numCols, lb);
 
+    int firstCol = addColumns(numCols, obj, &lower[0], &upper[0], CPX_INTEGER);
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
 
-void CPLEX::addIntegerVariable(const double lower, const double upper, const double obj, string name) {
-    double up[1];
-    double lo[1];
-    up[0] = upper;
-    lo[0] = lower;
-
-    Check(CPXaddcols(env, problem, 1, 0, &obj, 0, 0, 0, lo, up, 0), env);
 
-    int col = getNumCols() - 1;
-    if (!name.empty()) {
-       Check(CPXchgname(env, problem, 'c', col, name.c_str()), env);
-       addKey(name, col);
-    }
-    char type = CPX_INTEGER;
-    Check(CPXchgctype(env, problem, 1, &col, &type), env);
+int CPLEX::addIntegerVariable(const double lower, const double upper, const double obj, string name) {
+    int col = addColumns(1, &obj, &lower, &upper, CPX_INTEGER);
+    nameColumn(col, name);
+    return col;
 }
 
 
 /**
  * obj        -> objective function coefficient
  * name       -> if not empty set the variable name
+ *
+ * Returns the index of the new column
  */
-void CPLEX::addBinaryVariable(const double obj, string name) {
+int CPLEX::addBinaryVariable(const double obj, string name) {
+    double lower = 0.0;
     double upper = 1.0;
-    Check(CPXaddcols(env, problem, 1, 0, &obj, 0, 0, 0, 0, &upper, 0), env);
-    //Check(CPXaddcols(env, problem, 1, 0, &obj, 0, 0, 0, &lower, &upper, 0));
-   
-    int col = getNumCols() - 1;
-    char type = CPX_BINARY;
-    Check(CPXchgname(env, problem, 'c', col, name.c_str()), env);
-    addKey(name, col);
-    Check(CPXchgctype(env, problem, 1, &col, &type), env);
+    int col = addColumns(1, &obj, &lower, &upper, CPX_BINARY);
+    nameColumn(col, name);
+    return col;
 }
 
 
@@ -242,29 +337,17 @@ void CPLEX::addBinaryVariable(const double obj, string name) {
  * numCols    -> number of variables to be added
  * obj        -> Array of size (numCols), objective function coefficients
  * name       -> if not empty set the variable name (includes index in the end starting from zero)
+ *
+ * Returns the index of the first new column, the others follow contiguously
  */
-void CPLEX::addBinaryVariables(int numCols, const double* obj, string& name) {
-    
-    vector<double> upper(numCols);
-    for (int i = 0; i < numCols; i++) {
-        upper[i] = 1.0;
-    }
-    Check(CPXaddcols(env, problem, numCols, 0, obj, 0, 0, 0, 0, &upper[0], 0), env);
-
-    vector<int> indices(numCols);
-    vector<char> type(numCols);
-    int currentCol = getNumCols() - numCols;
-
-    for (int i = 0; i < numCols; i++) {
-        indices[i] = currentCol;
-        type[i] = CPX_BINARY;
-        string n = name + lex(i);
-        Check(CPXchgname(env, problem, 'c', currentCol, n.c_str()), env);
-        addKey(n, currentCol);
-        currentCol++;
-    }
-    Check(CPXchgctype(env, problem, numCols, &indices[0], &type[0]), env);
+int CPLEX::addBinaryVariables(int numCols, const double* obj, string& name) {
     
+    vector<double> lower(numCols, 0.0);
+    vector<double> upper(numCols, 1.0);
+
+    int firstCol = addColumns(numCols, obj, &lower[0], &upper[0], CPX_BINARY);
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
 }
 
 
@@ -279,7 +362,6 @@ void CPLEX::addBinaryVariables(int numCols, const double* obj, string& name) {
  */
 void CPLEX::addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
     
-    int matbeg = 0;
     int numNonZero = (int)colNames.size();
 
     vector<int> colIndices(numNonZero);
@@ -288,17 +370,35 @@ void CPLEX::addRow(vector<string> colNames, vector<double> elements, double rhs,
         if (colIndices[i] == -1) printf("In addRow, colIndice was not found for variable %s. Is the name wrong?\n", colNames[i].c_str());
     }
 
-    Check(CPXaddrows(env, problem, 0, 1, numNonZero, &rhs, &sense, &matbeg, &colIndices[0], &elements[0], 0, 0), env);
+    addRow(numNonZero, colIndices.data(), elements.data(), rhs, sense, name);
+}
+
+/**
+ * numNonZero - number of non zero coefficients
+ * colIndices - array of size (numNonZero), column indices as returned by the add*Variable functions
+ * elements   - array of size (numNonZero), non zero coefficients
+ * rhs, sense and name as above
+ */
+void CPLEX::addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
     
-    int row = getNumRows() - 1;
+    if (building) {
+        if (useNames && !name.empty()) buffer.addRowName(getNumRows(), name);
+        buffer.addRow(numNonZero, colIndices, elements, rhs, sense);
+        if (buffer.getMemoryUsage() >= maxBufferBytes) flushBuild();
+        return;
+    }
+
+    int matbeg = 0;
 
-    if (!name.empty()) {
+    Check(CPXaddrows(env, problem, 0, 1, numNonZero, &rhs, &sense, &matbeg, colIndices, elements, 0, 0), env);
+    
+    if (useNames && !name.empty()) {
+        int row = getNumRows() - 1;
         Check(CPXchgname(env, problem, 'r', row, name.c_str()), env);
     }
 }
 
 void CPLEX::addLazyConstraint(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
-    int matbeg = 0;
     int numNonZero = (int)colNames.size();
 
     vector<int> colIndices(numNonZero);
@@ -307,13 +407,17 @@ void CPLEX::addLazyConstraint(vector<string> colNames, vector<double> elements,
         if (colIndices[i] == -1) printf("In addLazyConstraints, colIndice was not found for variable %s. Is the name wrong?\n", colNames[i].c_str());
     }
     
-    Check(CPXaddusercuts(env, problem, 1, numNonZero, &rhs, &sense, &matbeg, &colIndices[0], &elements[0], 0), env);
+    addLazyConstraint(numNonZero, colIndices.data(), elements.data(), rhs, sense, name);
 }
 
+void CPLEX::addLazyConstraint(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    flushBuild();
+    int matbeg = 0;
+    Check(CPXaddlazyconstraints(env, problem, 1, numNonZero, &rhs, &sense, &matbeg, colIndices, elements, 0), env);
+}
 
 
 void CPLEX::addUserCut(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
-    int matbeg = 0;
     int numNonZero = (int)colNames.size();
 
     vector<int> colIndices(numNonZero);
@@ -322,7 +426,21 @@ void CPLEX::addUserCut(vector<string> colNames, vector<double> elements, double
         if (colIndices[i] == -1) printf("In addUserCuts, colIndice was not found for variable %s. Is the name wrong?\n", colNames[i].c_str());
     }
     
-    Check(CPXaddusercuts(env, problem, 1, numNonZero, &rhs, &sense, &matbeg, &colIndices[0], &elements[0], 0), env);
+    addUserCut(numNonZero, colIndices.data(), elements.data(), rhs, sense, name);
+}
+
+void CPLEX::addUserCut(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    flushBuild();
+    int matbeg = 0;
+    Check(CPXaddusercuts(env, problem, 1, numNonZero, &rhs, &sense, &matbeg, colIndices, elements, 0), env);
+}
+
+void CPLEX::setColBounds(int col, double lower, double upper) {
+    flushBuild();
+    int    indices[2] = {col, col};
+    char   types[2]   = {'L', 'U'};
+    double bounds[2]  = {lower, upper};
+    Check(CPXchgbds(env, problem, 2, indices, types, bounds), env);
 }
 
 void CPLEX::setPriorityInBranching(vector<string> colNames, int priority) {
@@ -335,6 +453,7 @@ void CPLEX::setPriorityInBranching(vector<string> colNames, int priority) {
 }
 
 void CPLEX::setPriorityInBranching(vector<string> colNames, vector<int> priorities) {
+    flushBuild();
     int cnt = (int) colNames.size();
 
     vector<int> indices(cnt);
@@ -352,6 +471,7 @@ void CPLEX::setPriorityInBranching(vector<string> colNames, vector<int> prioriti
 
 
 void CPLEX::relax() { 
+    flushBuild();
     Check(CPXchgprobtype(env, problem, CPXPROB_LP), env); 
 }
 
@@ -362,11 +482,24 @@ void CPLEX::relax() {
 #endif
 
 void CPLEX::doSolve() {
+    flushBuild();
     int type = CPXgetprobtype(env, problem);
-    Check(type == CPXPROB_MILP ? CPXmipopt(env, problem) : OPTIMIZE(env, problem), env);
+    objSense = CPXgetobjsen(env, problem);
+    numCols  = CPXgetnumcols(env, problem);
+    if (type == CPXPROB_MILP) registerCallbacks();
+    int result = type == CPXPROB_MILP ? CPXmipopt(env, problem) : OPTIMIZE(env, problem);
+    terminateFlag = 0;
+    Check(result, env);
     status = CPXgetstat(env, problem);
 }
 
+// Nodes whose relaxation does not beat it are pruned, the solve is stopped once the bound reaches it.
+// Legacy callbacks (with a solve callback) only stop the solve
+void CPLEX::setCutoff(double value) {
+    cutoff = value;
+    hasCutoff = true;
+}
+
 int CPLEX::getStatus() { 
     return status; 
 }
@@ -543,6 +676,8 @@ void CPLEX::debugLevel(int debugLevel) {
 }
 
 void CPLEX::exportModel(const char* filename) {
+    flushBuild();
+    flushNames();
     Check(CPXwriteprob(env, problem, filename, 0), env);
 }
 
@@ -624,44 +759,234 @@ bool CPLEX::isNumericalDifficulties() {
 
 
 
+// Callbacks are registered when solving, see registerCallbacks
 void CPLEX::addLazyCallback(void* userData) {
-    // Ask for variables in terms of original problem instead of presolved.
-    Check(CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF), env);
-    Check(CPXsetintparam(env, CPX_PARAM_PRELINEAR, CPX_OFF), env);
-    Check(CPXsetlazyconstraintcallbackfunc(env, functionCallback, userData), env);
+    lazyData = userData;
 }
 
 void CPLEX::addUserCutCallback(void* userData) {
-    // Ask for variables in terms of original problem instead of presolved.
-    Check(CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF), env);
-    Check(CPXsetintparam(env, CPX_PARAM_PRELINEAR, CPX_OFF), env);
-    Check(CPXsetusercutcallbackfunc(env, functionCallback, userData), env);
+    userCutData = userData;
 }
 
 void CPLEX::addIncumbentCallback(void* userData) {
-    Check(CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF), env);
-    Check(CPXsetincumbentcallbackfunc(env, incumbentCallback, userData), env);
+    incumbentData = userData;
 }
 
 void CPLEX::addInfoCallback(void* userData) {
-    Check(CPXsetinfocallbackfunc(env, infoCallback, userData), env);
+    infoData = userData;
 }
 
 void CPLEX::addNodeCallback(void* userData) {
-    Check(CPXsetnodecallbackfunc(env, nodeCallback, userData), env);
+    nodeData = userData;
 }
 
 void CPLEX::addSolveCallback(void* userData) {
-    Check(CPXsetsolvecallbackfunc(env, solveCallback, userData), env);
+    // Node models are written to lp files
+    flushNames();
+    solveData = userData;
+}
+
+/**
+ * Callbacks use the generic API, which keeps presolve and dynamic search on and is called from
+ * several threads at once. Solve callbacks (exporting node models) only exist in the legacy API,
+ * the two cannot be mixed, so if there is one every callback is registered as a legacy one.
+ */
+void CPLEX::registerCallbacks() {
+    if (solveData) {
+        registerLegacyCallbacks();
+        return;
+    }
+
+    // A race listens to the solve and gives it cutoffs while it runs
+    CPXLONG mask = 0;
+    if (lazyData || incumbentData)                     mask |= CPX_CALLBACKCONTEXT_CANDIDATE;
+    if (userCutData || listener || hasCutoff)          mask |= CPX_CALLBACKCONTEXT_RELAXATION;
+    if (infoData || nodeData || listener || hasCutoff) mask |= CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS;
+    Check(CPXcallbacksetfunc(env, problem, mask, mask ? genericCallback : NULL, this), env);
+}
+
+void CPLEX::registerLegacyCallbacks() {
+    // Ask for variables in terms of original problem instead of presolved.
+    if (lazyData || userCutData || incumbentData) Check(CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF), env);
+    if (lazyData || userCutData)                  Check(CPXsetintparam(env, CPX_PARAM_PRELINEAR,  CPX_OFF), env);
+
+    Check(CPXsetlazyconstraintcallbackfunc(env, lazyData      ? functionCallback  : NULL, this),          env);
+    Check(CPXsetusercutcallbackfunc       (env, userCutData   ? functionCallback  : NULL, this),          env);
+    Check(CPXsetincumbentcallbackfunc     (env, incumbentData ? incumbentCallback : NULL, incumbentData), env);
+    Check(CPXsetnodecallbackfunc          (env, nodeData      ? nodeCallback      : NULL, nodeData),      env);
+    Check(CPXsetsolvecallbackfunc         (env, solveCallback, solveData),                                 env);
+    bool info = infoData || listener || hasCutoff;
+    Check(CPXsetinfocallbackfunc          (env, info          ? infoCallback      : NULL, this),          env);
+}
+
+/**
+ * GENERIC CALLBACKS
+ *
+ */
+
+int CPXPUBLIC CPLEX::genericCallback(CPXCALLBACKCONTEXTptr context, CPXLONG contextId, void* userHandle) {
+    CPLEX* cplex = static_cast<CPLEX*>(userHandle);
+    switch (contextId) {
+        case CPX_CALLBACKCONTEXT_CANDIDATE:       return cplex->candidateCallback(context);
+        case CPX_CALLBACKCONTEXT_RELAXATION:      return cplex->relaxationCallback(context);
+        case CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS: return cplex->progressCallback(context);
+    }
+    return 0;
 }
 
+/**
+ * Buffers of the callbacks, one set per CPLEX thread. They are reused from call to call, so once they
+ * have grown the callbacks do not allocate.
+ */
+struct CallbackWorkspace {
+    vector<double> x;
+    CutBuffer      cuts;
+    vector<double> violations;
+    CutBuffer      violated;
+    CutSelector    selector;
+    vector<char>   decisions;
+    vector<int>    purgeable;
+    vector<int>    local;
+};
+
+static thread_local CallbackWorkspace workspace;
+
+// Copies the cuts violated by x, in the form CPLEX takes them
+static int violatedCuts(const CutBuffer& cuts, const double* x, CutBuffer& violated) {
+    vector<double>& violations = workspace.violations;
+    cuts.getViolations(x, violations);
+    violated.clear();
+    for (int i = 0; i < cuts.getNumCuts(); i++) {
+        if (violations[i] > CUT_TOLERANCE) violated.addCut(cuts, i);
+    }
+    return violated.getNumCuts();
+}
+
+// Copies the user cuts chosen by the selection, purgeable tells CPLEX how to use each of them
+static int selectedCuts(const CutBuffer& cuts, const double* x, int budget, double maxParallelism, CutBuffer& selected,
+                        vector<int>& purgeable) {
+    vector<char>& decisions = workspace.decisions;
+    workspace.selector.select(cuts, x, CUT_TOLERANCE, budget, maxParallelism, decisions);
+    selected.clear();
+    purgeable.clear();
+    for (int i = 0; i < cuts.getNumCuts(); i++) {
+        if (decisions[i] == CUT_DROPPED) continue;
+        selected.addCut(cuts, i);
+        purgeable.push_back(decisions[i] == CUT_FORCED ? CPX_USECUT_FORCE : decisions[i] == CUT_PURGEABLE ? CPX_USECUT_PURGE : CPX_USECUT_FILTER);
+    }
+    return selected.getNumCuts();
+}
+
+// Integer solutions: lazy constraints reject them, otherwise they are the new incumbent
+int CPLEX::candidateCallback(CPXCALLBACKCONTEXTptr context) {
+    int isPoint = 0;
+    CPXcallbackcandidateispoint(context, &isPoint);
+    if (!isPoint) return 0;
+
+    vector<double>& x = workspace.x;
+    x.resize(numCols);
+    double objValue;
+    int result = CPXcallbackgetcandidatepoint(context, &x[0], 0, numCols - 1, &objValue);
+    if (result != 0) {
+        printf("Error in Callback, status = %d\n", result);
+        return result;
+    }
+
+    if (lazyData) {
+        Model* model = static_cast<Model*>(lazyData);
+        workspace.cuts.clear();
+        model->separate(x, workspace.cuts);
+
+        CutBuffer& v = workspace.violated;
+        int numCuts = violatedCuts(workspace.cuts, &x[0], v);
+        if (numCuts > 0) return CPXcallbackrejectcandidate(context, numCuts, v.getNumNonZeros(), v.getRhs(), v.getSense(), v.getRowBeg(),
+                                                           v.getRowInd(), v.getRowVal());
+    }
+
+    if (incumbentData) {
+        Model* model = static_cast<Model*>(incumbentData);
+        model->incumbentFound(objValue, &x[0]);
+    }
+    return 0;
+}
+
+// Fractional solutions: nodes that cannot beat the cutoff are pruned, otherwise user cuts
+int CPLEX::relaxationCallback(CPXCALLBACKCONTEXTptr context) {
+    vector<double>& x = workspace.x;
+    x.resize(numCols);
+    double objValue;
+    int result = CPXcallbackgetrelaxationpoint(context, &x[0], 0, numCols - 1, &objValue);
+    if (result != 0) {
+        printf("Error in Callback, status = %d\n", result);
+        return result;
+    }
+
+    if (reachedCutoff(objValue)) return CPXcallbackprunenode(context);
+
+    if (userCutData) {
+        Model* model = static_cast<Model*>(userCutData);
+        workspace.cuts.clear();
+        model->separate(x, workspace.cuts);
+
+        CutBuffer& v = workspace.violated;
+        int numCuts = selectedCuts(workspace.cuts, &x[0], cutBudget, cutMaxParallelism, v, workspace.purgeable);
+        workspace.local.assign(numCuts, 0);
+        if (numCuts > 0) return CPXcallbackaddusercuts(context, numCuts, v.getNumNonZeros(), v.getRhs(), v.getSense(), v.getRowBeg(),
+                                                       v.getRowInd(), v.getRowVal(), &workspace.purgeable[0], &workspace.local[0]);
+    }
+    return 0;
+}
+
+int CPLEX::progressCallback(CPXCALLBACKCONTEXTptr context) {
+    int hasIncumbent = 0;
+    CPXLONG nodeCount = 0;
+    double solValue = 0;
+    double bound    = 0;
+    CPXcallbackgetinfoint (context, CPXCALLBACKINFO_FEASIBLE,  &hasIncumbent);
+    CPXcallbackgetinfolong(context, CPXCALLBACKINFO_NODECOUNT, &nodeCount);
+    CPXcallbackgetinfodbl (context, CPXCALLBACKINFO_BEST_BND,  &bound);
+    if (hasIncumbent) CPXcallbackgetinfodbl(context, CPXCALLBACKINFO_BEST_SOL, &solValue);
+
+    if (infoData && hasIncumbent) static_cast<Model*>(infoData)->bestSolutionValueCallbackFunction(solValue);
+
+    // Once a node has been processed the root is over, its bound includes CPLEX's cut rounds.
+    // Only the first report is kept by the model
+    void* firstNodeData = infoData ? infoData : nodeData;
+    if (firstNodeData && nodeCount >= 1) static_cast<Model*>(firstNodeData)->firstNodeBoundCallbackFunction(bound);
+
+    if (listener) {
+        if (hasIncumbent) listener->newIncumbent(this, solValue);
+        listener->newBound(this, bound);
+        listener->newNodeCount(this, (int)nodeCount);
+    }
+
+    if (reachedCutoff(bound)) CPXcallbackabort(context);
+    return 0;
+}
+
+// Nothing better than the cutoff is left
+bool CPLEX::reachedCutoff(double bound) {
+    if (!hasCutoff) return false;
+    double limit = cutoff;
+    double tol   = CUTOFF_TOLERANCE * std::max(1.0, fabs(limit));
+    return objSense == CPX_MAX ? bound <= limit + tol : bound >= limit - tol;
+}
+
+/**
+ * LEGACY CALLBACKS
+ *
+ */
 
 int CPXPUBLIC CPLEX::functionCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p) {
 
-    Model* model = static_cast<Model*>(cbhandle);
+    // Lazy constraints are separated at integer solutions, user cuts in the cut loop
+    CPLEX* cplex = static_cast<CPLEX*>(cbhandle);
+    bool lazy = wherefrom == CPX_CALLBACK_MIP_CUT_FEAS || wherefrom == CPX_CALLBACK_MIP_CUT_UNBD;
+    Model* model = static_cast<Model*>(lazy ? cplex->lazyData : cplex->userCutData);
     
-    int numCols = model->getSolver()->getNumCols();
-    vector<double> x(numCols);
+    int numCols = cplex->numCols;
+    vector<double>& x = workspace.x;
+    x.resize(numCols);
     int status = CPXgetcallbacknodex(env, cbdata, wherefrom, &x[0], 0, numCols-1);
     //int status = CPXgetcallbackincumbent(env, cbdata, wherefrom, &x[0], 0, numCols-1);
     if (status != 0) {
@@ -680,12 +1005,21 @@ int CPXPUBLIC CPLEX::functionCallback(CPXCENVptr env, void* cbdata, int wherefro
     //}
     ///////////////////
 
-    vector<SolverCut> cuts = model->separationAlgorithm(x);
-    for (int i  = 0; i < (int)cuts.size(); i++) {
-        vector<int> indices  = cuts[i].getIndices();
-        vector<double> coefs = cuts[i].getCoefs();
-        CPXcutcallbackadd(env, cbdata, wherefrom, (int)cuts[i].getNumCoefs(), cuts[i].getRHS(), 
-                          cuts[i].getSense(), &indices[0], &coefs[0], CPX_USECUT_FORCE);
+    workspace.cuts.clear();
+    model->separate(x, workspace.cuts);
+
+    const CutBuffer* cuts = &workspace.cuts;
+    vector<int>& purgeable = workspace.purgeable;
+    if (lazy) {
+        purgeable.assign(cuts->getNumCuts(), CPX_USECUT_FORCE);
+    } else {
+        selectedCuts(workspace.cuts, &x[0], cplex->cutBudget, cplex->cutMaxParallelism, workspace.violated, purgeable);
+        cuts = &workspace.violated;
+    }
+    for (int i  = 0; i < cuts->getNumCuts(); i++) {
+        int beg = cuts->getBegin(i);
+        CPXcutcallbackadd(env, cbdata, wherefrom, cuts->getEnd(i) - beg, cuts->getRhs()[i], 
+                          cuts->getSense()[i], cuts->getRowInd() + beg, cuts->getRowVal() + beg, purgeable[i]);
     }
     
     return 0;
@@ -695,7 +1029,7 @@ int CPXPUBLIC CPLEX::functionCallback(CPXCENVptr env, void* cbdata, int wherefro
 int CPXPUBLIC CPLEX::incumbentCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, double objval, 
                                        double *x, int *isfeas_p, int* useraction_p) {
     Model* model = static_cast<Model*>(cbhandle);
-    model->incumbentCallbackFunction(objval, x);
+    model->incumbentFound(objval, x);
     return 0;
 }
 
@@ -710,32 +1044,37 @@ int CPXPUBLIC CPLEX::nodeCallback(CPXCENVptr env, void* cbdata, int wherefrom, v
 
 int CPXPUBLIC CPLEX::infoCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle) {
 
-    Model* model = static_cast<Model*>(cbhandle);
-    
-    double solValue;
-    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_INTEGER, &solValue);
-    model->bestSolutionValueCallbackFunction(solValue);
+    CPLEX* cplex = static_cast<CPLEX*>(cbhandle);
     
+    int hasIncumbent = 0;
     int nodeCount;
-    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_NODE_COUNT, &nodeCount);
-    if (nodeCount > 1) return 0;
+    double solValue;
+    double bound;
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MIP_FEAS,       &hasIncumbent);
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_INTEGER,   &solValue);
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_NODE_COUNT,     &nodeCount);
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_REMAINING, &bound);
+
+    if (cplex->infoData) {
+        Model* model = static_cast<Model*>(cplex->infoData);
+        if (hasIncumbent) model->bestSolutionValueCallbackFunction(solValue);
+        if (nodeCount == 1) model->firstNodeBoundCallbackFunction(bound);
+    }
 
-    if (nodeCount == 1) {
-        double value;
-        CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_REMAINING, &value);
-        model->firstNodeBoundCallbackFunction(value);
+    if (cplex->listener) {
+        if (hasIncumbent) cplex->listener->newIncumbent(cplex, solValue);
+        cplex->listener->newBound(cplex, bound);
+        cplex->listener->newNodeCount(cplex, nodeCount);
     }
-    
-    // Not sure if this should be uncommented, look at Kiva version
-    //if (model->isSolutionGoodEnough(solValue)) return 1;
 
-    return 0;
+    return cplex->reachedCutoff(bound) ? 1 : 0;
 }
 
 
 int CPXPUBLIC CPLEX::solveCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p) {
 
     Model* model = static_cast<Model*>(cbhandle);
+    std::lock_guard<std::mutex> guard(model->getCallbackMutex());
 
     if (model->shouldExportMoreSolverModels() && !model->shouldCaptureCuts()) {
         CPXLPptr  nodelp;
@@ -12,6 +12,8 @@
 //#include <ilcplex/ilocplex.h>
 #include <ilcplex/cplex.h>
 #include "Solver.h"
+#include "BuildBuffer.h"
+#include <atomic>
 
 
 /**
@@ -24,6 +26,40 @@ class CPLEX : public Solver {
         CPXENVptr env;
         CPXLPptr problem;
 
+        // Build transaction
+        bool        building;
+        size_t      maxBufferBytes;
+        BuildBuffer buffer;
+        void flushBuild();
+        void addBulk(const BuildBuffer& b);
+        int  addColumns(int numCols, const double* obj, const double* lower, const double* upper, char type);
+
+        // Callbacks, registered when solving
+        void* lazyData;
+        void* userCutData;
+        void* incumbentData;
+        void* infoData;
+        void* nodeData;
+        void* solveData;
+        int   numCols;
+        int    cutBudget;
+        double cutMaxParallelism;
+        void registerCallbacks();
+        void registerLegacyCallbacks();
+
+        static int CPXPUBLIC genericCallback(CPXCALLBACKCONTEXTptr context, CPXLONG contextId, void* userHandle);
+        int candidateCallback (CPXCALLBACKCONTEXTptr context);
+        int relaxationCallback(CPXCALLBACKCONTEXTptr context);
+        int progressCallback  (CPXCALLBACKCONTEXTptr context);
+        bool reachedCutoff(double bound);
+
+        // Set by terminate, CPLEX polls it
+        volatile int terminateFlag;
+        int objSense;
+        std::atomic<bool>   hasCutoff;
+        std::atomic<double> cutoff;
+
+        // Legacy callbacks, only used along with a solve callback
         static int CPXPUBLIC functionCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p);
         static int CPXPUBLIC incumbentCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, double objval, 
                                                double *x, int *isfeas_p, int* useraction_p);
@@ -31,6 +67,12 @@ class CPLEX : public Solver {
         static int CPXPUBLIC infoCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle);
         static int CPXPUBLIC solveCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p);
 
+        void nameColumn(int col, const string& name);
+
+    protected:
+
+        virtual void writeColNames(const vector<int>& indices, const vector<string>& names);
+        virtual void writeRowNames(const vector<int>& indices, const vector<string>& names);
 
 
     public:
@@ -41,23 +83,30 @@ class CPLEX : public Solver {
         virtual void deleteAndRecreateProblem();
         virtual void readProblem(string filename);
         virtual int isMIP();
+        virtual void beginBuild(size_t maxBytes);
+        virtual void endBuild();
+        virtual void loadModel(const ModelIR& ir);
 
         // Set data
         virtual void changeObjectiveSense(bool isMax);
-        virtual void addVariable(const double lower, const double upper, const double obj, string name);
-        virtual void addVariables(int numCols, const double lower, const double upper, const double* obj, string& name);
-        virtual void addBinaryVariable(const double obj, string name);
-        virtual void addBinaryVariables(int numCols, const double* obj, string& name);
-        virtual void addIntegerVariable(const double lower, const double upper, const double obj, string name);
-        virtual void addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name);
+        virtual int addVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addVariables(int numCols, const double lower, const double upper, const double* obj, string& name);
+        virtual int addBinaryVariable(const double obj, string name);
+        virtual int addBinaryVariables(int numCols, const double* obj, string& name);
+        virtual int addIntegerVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name);
         // SENSE
         // L - <=
         // E - ==
         // G - >=
         virtual void addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
 
         virtual void addLazyConstraint(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addLazyConstraint(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
         virtual void addUserCut(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addUserCut(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
+        virtual void setColBounds(int col, double lower, double upper);
 
         virtual void setPriorityInBranching(vector<string> colNames, int priority);
         virtual void setPriorityInBranching(vector<string> colNames, vector<int> priorities);
@@ -68,6 +117,8 @@ class CPLEX : public Solver {
 
         virtual void relax();
         virtual void doSolve();
+        virtual void setCutoff(double value);
+        virtual void terminate() { terminateFlag = 1; }
         
         // Get data
         virtual int getNumCols();
@@ -92,6 +143,7 @@ class CPLEX : public Solver {
         virtual void setSolverCuts(int solverCuts =  0, int clique   = -2, int cover    = -2, int disj = -2, int landp  = -2, 
                                    int flowcover  = -2, int flowpath = -2, int gomory   = -2, int gub  = -2, int implbd = -2,
                                    int mir        = -2, int mcf      = -2, int zerohalf = -2);
+        virtual void setCutSelection(int budget, double maxParallelism) { cutBudget = budget; cutMaxParallelism = maxParallelism; }
  
         
         // 0 - balanced, 1 - feasibility, 2 - optimality
@@ -0,0 +1,87 @@
+/**
+ * CPLEXEnvPool.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "CPLEXEnvPool.h"
+#include "Solver.h"
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+// Destroyed at exit, which closes the idle environments
+CPLEXEnvPool* CPLEXEnvPool::getInstance() {
+    static CPLEXEnvPool pool;
+    return &pool;
+}
+
+CPLEXEnvPool::CPLEXEnvPool() {
+    maxIdle = 1;
+    opened  = 0;
+    reused  = 0;
+}
+
+CPLEXEnvPool::~CPLEXEnvPool() {
+    for (CPXENVptr env : idle) CPXcloseCPLEX(&env);
+    idle.clear();
+}
+
+void CPLEXEnvPool::setMaxIdle(int max) {
+    std::lock_guard<std::mutex> guard(lock);
+    maxIdle = max;
+    while ((int)idle.size() > maxIdle) {
+        CPXENVptr env = idle.back();
+        idle.pop_back();
+        CPXcloseCPLEX(&env);
+    }
+}
+
+/**
+ * LEASES
+ *
+ */
+
+CPXENVptr CPLEXEnvPool::acquire() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!idle.empty()) {
+            CPXENVptr env = idle.back();
+            idle.pop_back();
+            reused++;
+            return env;
+        }
+        opened++;
+    }
+
+    int status = 0;
+    CPXENVptr env = CPXopenCPLEX(&status);
+    if (status != 0 || env == NULL) throw SolverError(status);
+    return env;
+}
+
+// Every problem created in env must have been freed
+void CPLEXEnvPool::release(CPXENVptr env) {
+    if (env == NULL) return;
+    reset(env);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if ((int)idle.size() < maxIdle) idle.push_back(env);
+    else                            CPXcloseCPLEX(&env);
+}
+
+// Callbacks and the terminate flag are not parameters, CPXsetdefaults leaves them in place
+void CPLEXEnvPool::reset(CPXENVptr env) {
+    CPXsetdefaults(env);
+    CPXsetlazyconstraintcallbackfunc(env, NULL, NULL);
+    CPXsetusercutcallbackfunc(env, NULL, NULL);
+    CPXsetincumbentcallbackfunc(env, NULL, NULL);
+    CPXsetinfocallbackfunc(env, NULL, NULL);
+    CPXsetnodecallbackfunc(env, NULL, NULL);
+    CPXsetsolvecallbackfunc(env, NULL, NULL);
+    CPXsetterminate(env, NULL);
+}
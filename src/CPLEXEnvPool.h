@@ -0,0 +1,53 @@
+/**
+ * CPLEXEnvPool.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef CPLEXENVPOOL_H
+#define CPLEXENVPOOL_H
+
+#include <ilcplex/cplex.h>
+#include <mutex>
+#include "Util.h"
+
+/**
+ * Pool of CPLEX environments, so that opening an environment (and checking out a license)
+ * is paid once rather than once per CPLEX object.
+ *
+ * Environments are returned with all parameters back at their defaults and no callbacks,
+ * so a leased environment behaves as a freshly opened one. At most maxIdle environments are
+ * kept, the rest are closed on release. Idle environments are closed when the program ends.
+ */
+class CPLEXEnvPool {
+
+    private:
+
+        std::mutex lock;
+        vector<CPXENVptr> idle;
+        int maxIdle;
+
+        int opened;
+        int reused;
+
+        void reset(CPXENVptr env);
+
+    public:
+
+        // Singleton instance
+        static CPLEXEnvPool* getInstance();
+
+        CPLEXEnvPool();
+        ~CPLEXEnvPool();
+
+        CPXENVptr acquire();
+        void release(CPXENVptr env);
+
+        void setMaxIdle(int max);
+        int getOpened() { return opened; }
+        int getReused() { return reused; }
+};
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * CutBuffer.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "CutBuffer.h"
+
+// AVX2 is chosen at run time, the rest of the build does not need to target it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CUTBUFFER_AVX2
+#include <immintrin.h>
+#endif
+
+CutBuffer::CutBuffer() {
+    rowBeg.push_back(0);
+}
+
+CutBuffer::~CutBuffer() {
+}
+
+void CutBuffer::discardCoefs() {
+    rowInd.resize(rowBeg.back());
+    rowVal.resize(rowBeg.back());
+}
+
+int CutBuffer::addCut(char s, double r) {
+    if (s != 'L' && s != 'G' && s != 'E')
+        Util::throwInvalidArgument("Error in addCut: Invalid sense %c (valid values are 'L', 'E' and 'G').", s);
+    rhs.push_back(r);
+    sense.push_back(s);
+    rowBeg.push_back((int)rowInd.size());
+    return (int)rhs.size() - 1;
+}
+
+int CutBuffer::addCut(int numNonZero, const int* colIndices, const double* elements, char s, double r) {
+    discardCoefs();
+    rowInd.insert(rowInd.end(), colIndices, colIndices + numNonZero);
+    rowVal.insert(rowVal.end(), elements,   elements   + numNonZero);
+    return addCut(s, r);
+}
+
+int CutBuffer::addCut(const CutBuffer& other, int i) {
+    int beg = other.getBegin(i);
+    return addCut(other.getEnd(i) - beg, other.getRowInd() + beg, other.getRowVal() + beg, other.getSense()[i], other.getRhs()[i]);
+}
+
+void CutBuffer::keepCuts(int first, const vector<char>& keep) {
+    discardCoefs();
+    int numCuts = first;
+    int numNonZeros = rowBeg[first];
+    for (int i = first; i < getNumCuts(); i++) {
+        if (!keep[i - first]) continue;
+        for (int k = rowBeg[i]; k < rowBeg[i + 1]; k++) {
+            rowInd[numNonZeros] = rowInd[k];
+            rowVal[numNonZeros] = rowVal[k];
+            numNonZeros++;
+        }
+        rhs[numCuts]   = rhs[i];
+        sense[numCuts] = sense[i];
+        numCuts++;
+        rowBeg[numCuts] = numNonZeros;
+    }
+    rhs.resize(numCuts);
+    sense.resize(numCuts);
+    rowBeg.resize(numCuts + 1);
+    rowInd.resize(numNonZeros);
+    rowVal.resize(numNonZeros);
+}
+
+void CutBuffer::clear() {
+    rhs.clear();
+    sense.clear();
+    rowBeg.resize(1);
+    rowInd.clear();
+    rowVal.clear();
+}
+
+double CutBuffer::getActivity(int i, const double* x) const {
+    double activity = 0;
+    for (int k = rowBeg[i]; k < rowBeg[i + 1]; k++) activity += rowVal[k] * x[rowInd[k]];
+    return activity;
+}
+
+bool CutBuffer::isViolated(int i, const double* x, double tolerance) const {
+    double activity = getActivity(i, x);
+    char   s        = sense[i];
+    return (s != 'G' && activity > rhs[i] + tolerance) || (s != 'L' && activity < rhs[i] - tolerance);
+}
+
+/**
+ * BATCH EVALUATION
+ *
+ */
+
+// Left-hand sides of all cuts, one row after the other over the CSR arrays
+static void computeActivities(int numCuts, const int* beg, const int* ind, const double* val, const double* x, double* activities) {
+    for (int i = 0; i < numCuts; i++) {
+        double activity = 0;
+        for (int k = beg[i]; k < beg[i + 1]; k++) activity += val[k] * x[ind[k]];
+        activities[i] = activity;
+    }
+}
+
+#ifdef CUTBUFFER_AVX2
+// Same, gathering four values of x at a time
+__attribute__((target("avx2")))
+static void computeActivitiesAVX2(int numCuts, const int* beg, const int* ind, const double* val, const double* x, double* activities) {
+    for (int i = 0; i < numCuts; i++) {
+        int k   = beg[i];
+        int end = beg[i + 1];
+        __m256d zero = _mm256_setzero_pd();
+        __m256d all  = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        __m256d sum  = zero;
+        for (; k + 4 <= end; k += 4) {
+            __m128i cols = _mm_loadu_si128((const __m128i*)(ind + k));
+            __m256d xs   = _mm256_mask_i32gather_pd(zero, x, cols, all, 8);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(xs, _mm256_loadu_pd(val + k)));
+        }
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+        double activity = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        for (; k < end; k++) activity += val[k] * x[ind[k]];
+        activities[i] = activity;
+    }
+}
+
+static bool hasAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+void CutBuffer::getViolations(const double* x, double* violations) const {
+    int numCuts = getNumCuts();
+#ifdef CUTBUFFER_AVX2
+    if (hasAVX2()) computeActivitiesAVX2(numCuts, rowBeg.data(), rowInd.data(), rowVal.data(), x, violations);
+    else
+#endif
+    computeActivities(numCuts, rowBeg.data(), rowInd.data(), rowVal.data(), x, violations);
+
+    for (int i = 0; i < numCuts; i++) {
+        double d = violations[i] - rhs[i];
+        violations[i] = sense[i] == 'L' ? d : sense[i] == 'G' ? -d : fabs(d);
+    }
+}
+
+void CutBuffer::getViolations(const double* x, vector<double>& violations) const {
+    violations.resize(getNumCuts());
+    if (!violations.empty()) getViolations(x, &violations[0]);
+}
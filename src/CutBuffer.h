@@ -0,0 +1,78 @@
+/**
+ * CutBuffer.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef CUTBUFFER_H
+#define CUTBUFFER_H
+
+#include "Util.h"
+
+/**
+ * Cuts found by a separation, stored in CSR form (rowBeg, rowInd, rowVal) as in BuildBuffer.
+ *
+ * A cut is built by adding its coefficients and then closing it with addCut. Clearing the buffer
+ * keeps its memory, so a buffer reused by the same thread stops allocating once it has grown to
+ * the largest separation seen.
+ */
+class CutBuffer {
+
+    private:
+
+        vector<double> rhs;
+        vector<char>   sense;
+        // One more entry than cuts, the last one is where the cut being built starts
+        vector<int>    rowBeg;
+        vector<int>    rowInd;
+        vector<double> rowVal;
+
+    public:
+
+        CutBuffer();
+        ~CutBuffer();
+
+        // Coefficient of the cut being built
+        void addCoef(int index, double coef) {
+            rowInd.push_back(index);
+            rowVal.push_back(coef);
+        }
+        // Number of coefficients of the cut being built
+        int  getNumOpenCoefs() const { return (int)rowInd.size() - rowBeg.back(); }
+        // Drops the coefficients of the cut being built
+        void discardCoefs();
+
+        // Closes the cut being built, s: 'L' (<=), 'E' (==) or 'G' (>=). Returns its index
+        int  addCut(char s, double r);
+        int  addCut(int numNonZero, const int* colIndices, const double* elements, char s, double r);
+        // Copies cut i of another buffer
+        int  addCut(const CutBuffer& other, int i);
+        // Removes, in place, the cuts i >= first with keep[i - first] == 0
+        void keepCuts(int first, const vector<char>& keep);
+        void clear();
+
+        // Left-hand side of cut i at x
+        double getActivity(int i, const double* x) const;
+        bool   isViolated (int i, const double* x, double tolerance) const;
+
+        // Violations of every cut at x in one pass, violations[i] is by how much x violates cut i
+        // (negative if it is satisfied with slack). Uses AVX2 gathers if the CPU has them
+        void getViolations(const double* x, double* violations) const;
+        void getViolations(const double* x, vector<double>& violations) const;
+
+        int getNumCuts()      const { return (int)rhs.size();    }
+        int getNumNonZeros()  const { return rowBeg.back();      }
+        bool isEmpty()        const { return rhs.empty();        }
+        int getBegin(int i)   const { return rowBeg[i];          }
+        int getEnd(int i)     const { return rowBeg[i + 1];      }
+
+        const double* getRhs()      const { return rhs.data();    }
+        const char*   getSense()    const { return sense.data();  }
+        const int*    getRowBeg()   const { return rowBeg.data(); }
+        const int*    getRowInd()   const { return rowInd.data(); }
+        const double* getRowVal()   const { return rowVal.data(); }
+};
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * CutPool.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "CutPool.h"
+#include <cstring>
+
+// Cuts are only dropped once at least this fraction of the pool is too old, so that the pool is not
+// compacted at every check
+#define CUTPOOL_PURGE_FRACTION 0.1
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+CutPool::CutPool() {
+    maxAge = 0;
+    checks = 0;
+}
+
+CutPool::~CutPool() {
+}
+
+void CutPool::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    cuts.clear();
+    hashes.clear();
+    age.clear();
+    timesActive.clear();
+    index.clear();
+    checks = 0;
+}
+
+/**
+ * HASHING
+ *
+ */
+
+static uint64_t mix(uint64_t h, uint64_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    return h ^ (h >> 27);
+}
+
+static uint64_t bits(double v) {
+    v += 0.0; // -0.0 and 0.0 hash alike
+    uint64_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+// Leaves the canonical form of the cut in sorted
+uint64_t CutPool::hashCut(int numNonZero, const int* colIndices, const double* elements, char s, double r) {
+    sorted.clear();
+    for (int k = 0; k < numNonZero; k++) sorted.push_back(std::make_pair(colIndices[k], elements[k]));
+    std::sort(sorted.begin(), sorted.end());
+
+    uint64_t h = mix((uint64_t)s, bits(r));
+    for (const auto& p : sorted) h = mix(mix(h, (uint64_t)p.first), bits(p.second));
+    return h;
+}
+
+// Pooled cut equal to the one in sorted, -1 if none
+int CutPool::find(uint64_t hash, char s, double r) {
+    auto range = index.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+        int i = it->second;
+        int beg = cuts.getBegin(i);
+        if (cuts.getSense()[i] != s || cuts.getRhs()[i] != r || cuts.getEnd(i) - beg != (int)sorted.size()) continue;
+
+        bool same = true;
+        for (unsigned k = 0; k < sorted.size() && same; k++) {
+            same = cuts.getRowInd()[beg + k] == sorted[k].first && cuts.getRowVal()[beg + k] == sorted[k].second;
+        }
+        if (same) return i;
+    }
+    return -1;
+}
+
+/**
+ * POOL
+ *
+ */
+
+int CutPool::add(CutBuffer& buffer, int first, const double* x, double tolerance) {
+    std::lock_guard<std::mutex> guard(lock);
+    int numCuts = buffer.getNumCuts();
+    int numPooled = cuts.getNumCuts();
+    keep.assign(numCuts - first, 1);
+    reused.clear();
+
+    int removed = 0;
+    for (int i = first; i < numCuts; i++) {
+        int beg = buffer.getBegin(i);
+        char   s = buffer.getSense()[i];
+        double r = buffer.getRhs()[i];
+        uint64_t h = hashCut(buffer.getEnd(i) - beg, buffer.getRowInd() + beg, buffer.getRowVal() + beg, s, r);
+        // A pooled cut that x violates is kept once, the pool got it after x was checked
+        int existing = find(h, s, r);
+        if (existing != -1) {
+            bool repeated = existing >= numPooled || std::find(reused.begin(), reused.end(), existing) != reused.end();
+            if (!repeated && buffer.isViolated(i, x, tolerance)) {
+                reused.push_back(existing);
+            } else {
+                keep[i - first] = 0;
+                removed++;
+            }
+            continue;
+        }
+
+        for (const auto& p : sorted) cuts.addCoef(p.first, p.second);
+        index.insert(std::make_pair(h, cuts.addCut(s, r)));
+        hashes.push_back(h);
+        age.push_back(0);
+        timesActive.push_back(0);
+    }
+
+    if (removed > 0) buffer.keepCuts(first, keep);
+    return removed;
+}
+
+int CutPool::check(const double* x, double tolerance, CutBuffer& out) {
+    std::lock_guard<std::mutex> guard(lock);
+    checks++;
+    if (cuts.isEmpty()) return 0;
+
+    cuts.getViolations(x, violations);
+    int found   = 0;
+    int expired = 0;
+    for (int i = 0; i < cuts.getNumCuts(); i++) {
+        if (violations[i] > tolerance) {
+            out.addCut(cuts, i);
+            age[i] = 0;
+            timesActive[i]++;
+            found++;
+        } else if (++age[i] > maxAge) {
+            expired++;
+        }
+    }
+
+    if (expired > 0 && expired >= CUTPOOL_PURGE_FRACTION * cuts.getNumCuts()) purge();
+    return found;
+}
+
+// Drops the cuts older than maxAge
+void CutPool::purge() {
+    keep.resize(cuts.getNumCuts());
+    for (int i = 0; i < cuts.getNumCuts(); i++) keep[i] = age[i] <= maxAge;
+    cuts.keepCuts(0, keep);
+
+    index.clear();
+    int n = 0;
+    for (unsigned i = 0; i < keep.size(); i++) {
+        if (!keep[i]) continue;
+        hashes[n]      = hashes[i];
+        age[n]         = age[i];
+        timesActive[n] = timesActive[i];
+        index.insert(std::make_pair(hashes[n], n));
+        n++;
+    }
+    hashes.resize(n);
+    age.resize(n);
+    timesActive.resize(n);
+}
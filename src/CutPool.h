@@ -0,0 +1,72 @@
+/**
+ * CutPool.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef CUTPOOL_H
+#define CUTPOOL_H
+
+#include "CutBuffer.h"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * Cuts found by the separation of a model, shared by every thread (and solver) that calls it.
+ *
+ * Cuts are kept in canonical form (coefficients sorted by column) and indexed by a hash of that
+ * form, so a cut separated again is recognised whatever the order of its coefficients. Before the
+ * separation runs the pooled cuts are checked against the new point: a cut violated there is
+ * active and gets younger, the others age. Cuts older than maxAge are dropped.
+ *
+ * Cuts must be globally valid, as the solvers treat them.
+ */
+class CutPool {
+
+    private:
+
+        CutBuffer        cuts;
+        vector<uint64_t> hashes;
+        vector<int>      age;
+        vector<int>      timesActive;
+        std::unordered_multimap<uint64_t, int> index;
+
+        int  maxAge;
+        long checks;
+        std::mutex lock;
+
+        // Reused from call to call, always under the lock
+        vector<std::pair<int, double>> sorted;
+        vector<double> violations;
+        vector<char>   keep;
+        vector<int>    reused;
+
+        uint64_t hashCut(int numNonZero, const int* colIndices, const double* elements, char s, double r);
+        int  find(uint64_t hash, char s, double r);
+        void purge();
+
+    public:
+
+        CutPool();
+        ~CutPool();
+
+        // Pooled cuts not active in this many checks are dropped, 0 disables the pool
+        void setMaxAge(int a)  { maxAge = a;         }
+        bool isEnabled()       { return maxAge > 0;  }
+
+        // Appends the pooled cuts that x violates by more than tolerance to out, returns how many
+        int check(const double* x, double tolerance, CutBuffer& out);
+        // Pools cuts [first, end) of buffer, removing from it those repeated in it and those already
+        // pooled that x does not violate by more than tolerance. Another thread may have pooled a cut
+        // after this one checked the pool, x still needs it then. Returns how many were removed
+        int add(CutBuffer& buffer, int first, const double* x, double tolerance);
+        void clear();
+
+        int getNumCuts()           { return cuts.getNumCuts(); }
+        int getTimesActive(int i)  { return timesActive[i];    }
+};
+
+#endif
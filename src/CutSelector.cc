@@ -0,0 +1,121 @@
+/**
+ * CutSelector.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "CutSelector.h"
+#include "ThreadPool.h"
+
+// Added cuts at least this fraction as effective as the best one are forced
+#define CUTSELECT_STRONG_FRACTION   0.5
+#define CUTSELECT_MIN_NORM          1e-12
+// Candidates are scored on the pool when they have at least this many coefficients in total
+#define CUTSELECT_PARALLEL_NONZEROS 100000
+
+// Shared by every selector, started by the first round large enough to use it
+static ThreadPool& scoringPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+CutSelector::CutSelector() {
+}
+
+CutSelector::~CutSelector() {
+}
+
+/**
+ * SELECTION
+ *
+ */
+
+int CutSelector::select(const CutBuffer& candidates, const double* x, double tolerance, int budget, double maxParallelism,
+                        vector<char>& decisions) {
+    int n = candidates.getNumCuts();
+    decisions.assign(n, CUT_DROPPED);
+    if (n == 0) return 0;
+
+    candidates.getViolations(x, violations);
+    efficacy.resize(n);
+    norms.resize(n);
+    sorted.resize(candidates.getNumNonZeros());
+
+    if (candidates.getNumNonZeros() >= CUTSELECT_PARALLEL_NONZEROS) {
+        ThreadPool& pool = scoringPool();
+        int numTasks = std::min(n, pool.getNumThreads());
+        pool.run(numTasks, [&](int t) { score(candidates, t * n / numTasks, (t + 1) * n / numTasks); });
+    } else {
+        score(candidates, 0, n);
+    }
+
+    order.clear();
+    for (int i = 0; i < n; i++) if (violations[i] > tolerance) order.push_back(i);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return efficacy[a] > efficacy[b]; });
+    if (order.empty()) return 0;
+
+    double strong = CUTSELECT_STRONG_FRACTION * efficacy[order[0]];
+    selected.clear();
+    int kept = 0;
+    for (int i : order) {
+        if (budget > 0 && (int)selected.size() >= budget) {
+            decisions[i] = CUT_FILTERED;
+            kept++;
+            continue;
+        }
+
+        bool parallel = false;
+        for (unsigned s = 0; s < selected.size() && !parallel; s++) parallel = parallelism(candidates, i, selected[s]) > maxParallelism;
+        if (parallel) continue;
+
+        selected.push_back(i);
+        decisions[i] = efficacy[i] >= strong ? CUT_FORCED : CUT_PURGEABLE;
+        kept++;
+    }
+    return kept;
+}
+
+// Norm and efficacy of candidates first to last - 1, whose coefficients are also sorted by column
+void CutSelector::score(const CutBuffer& candidates, int first, int last) {
+    const int*    ind = candidates.getRowInd();
+    const double* val = candidates.getRowVal();
+    for (int i = first; i < last; i++) {
+        int beg = candidates.getBegin(i);
+        int end = candidates.getEnd(i);
+        double sum = 0;
+        for (int k = beg; k < end; k++) {
+            sorted[k] = std::make_pair(ind[k], val[k]);
+            sum += val[k] * val[k];
+        }
+        std::sort(sorted.begin() + beg, sorted.begin() + end);
+
+        norms[i]    = sqrt(sum);
+        efficacy[i] = violations[i] / std::max(norms[i], CUTSELECT_MIN_NORM);
+    }
+}
+
+// Cosine of the angle between two candidates, oriented as <= rows. Equalities are parallel either way
+double CutSelector::parallelism(const CutBuffer& candidates, int a, int b) {
+    if (norms[a] < CUTSELECT_MIN_NORM || norms[b] < CUTSELECT_MIN_NORM) return 0;
+
+    int ka = candidates.getBegin(a), endA = candidates.getEnd(a);
+    int kb = candidates.getBegin(b), endB = candidates.getEnd(b);
+    double dot = 0;
+    while (ka < endA && kb < endB) {
+        if      (sorted[ka].first < sorted[kb].first) ka++;
+        else if (sorted[ka].first > sorted[kb].first) kb++;
+        else dot += sorted[ka++].second * sorted[kb++].second;
+    }
+    char sa = candidates.getSense()[a];
+    char sb = candidates.getSense()[b];
+    if (sa == 'E' || sb == 'E') dot = fabs(dot);
+    else if (sa != sb)          dot = -dot;
+    return dot / (norms[a] * norms[b]);
+}
@@ -0,0 +1,76 @@
+/**
+ * CutSelector.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef CUTSELECTOR_H
+#define CUTSELECTOR_H
+
+#include "CutBuffer.h"
+
+// What to do with a candidate cut, see CutSelector::select
+enum CutDecision {
+    CUT_DROPPED = 0,
+    // Added and kept, as CPX_USECUT_FORCE
+    CUT_FORCED,
+    // Added, the solver may remove it later (CPX_USECUT_PURGE)
+    CUT_PURGEABLE,
+    // Handed to the solver, which decides whether to add it at all (CPX_USECUT_FILTER)
+    CUT_FILTERED
+};
+
+/**
+ * Chooses which of the user cuts separated in a round are added, so that the LP does not fill up with
+ * weak or redundant rows.
+ *
+ * Candidates are scored by efficacy (violation divided by the norm of the cut, i.e. the distance from
+ * the point to the cut hyperplane) and taken greedily, best first. A candidate too parallel to one
+ * already taken (cosine of the angle between them above maxParallelism) is dropped. Up to budget cuts
+ * are added: those at least half as effective as the best are forced, the others purgeable. The
+ * candidates left once the budget is used up are filtered.
+ *
+ * Selection runs on the calling thread, which is already one of the solver's (callback) threads. Only
+ * the scoring of large rounds is split over a pool shared by every selector, done by the calling thread
+ * alone while another selector uses it. A selector keeps its buffers from call to call, and must only
+ * be used by one thread at a time.
+ */
+class CutSelector {
+
+    private:
+
+        vector<double> violations;
+        vector<double> efficacy;
+        vector<int>    order;
+        vector<int>    selected;
+        // Coefficients of every candidate sorted by column, at the positions they have in the buffer
+        vector<std::pair<int, double>> sorted;
+        vector<double> norms;
+
+        void   score(const CutBuffer& candidates, int first, int last);
+        double parallelism(const CutBuffer& candidates, int a, int b);
+
+    public:
+
+        CutSelector();
+        ~CutSelector();
+
+        /**
+         * candidates     -> cuts separated at x
+         * tolerance      -> cuts violated by less than this are dropped
+         * budget         -> at most this many cuts are added (forced or purgeable), 0 for no limit
+         * maxParallelism -> cuts more parallel than this to an added one are dropped (1 keeps all)
+         * decisions      -> a CutDecision for each candidate
+         *
+         * Returns the number of cuts not dropped
+         */
+        int select(const CutBuffer& candidates, const double* x, double tolerance, int budget, double maxParallelism,
+                   vector<char>& decisions);
+
+        // Efficacy of candidate i in the last selection
+        double getEfficacy(int i) { return efficacy[i]; }
+};
+
+#endif
@@ -7,11 +7,11 @@
  */
 
 #include "Data.h"
-#include "Options.h"
 
 
-Data::Data() {
-    debug =  Options::getInstance()->getIntOption("debug");
+Data::Data(RunContext* ctx) {
+    context = ctx ? ctx : RunContext::getDefault();
+    debug   = context->getOptions()->getIntOption("debug");
 }
 
 Data::~Data() {
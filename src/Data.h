@@ -10,6 +10,7 @@
 #define DATA_H
 
 #include "Util.h"
+#include "RunContext.h"
 
 /**
  * Data data
@@ -18,11 +19,12 @@ class Data {
 
     protected:
         
+        RunContext* context;
         int debug;
 
     public:
 
-        Data();
+        Data(RunContext* ctx = NULL);
         virtual ~Data();
 
         virtual void readData() {}
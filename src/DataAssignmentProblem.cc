@@ -3,7 +3,7 @@
 #include "Options.h"
 
 
-DataAssignmentProblem::DataAssignmentProblem() : Data(){
+DataAssignmentProblem::DataAssignmentProblem(RunContext* ctx) : Data(ctx){
     numVariables  = 0;
 }
 
@@ -11,7 +11,7 @@ DataAssignmentProblem::~DataAssignmentProblem() {
 }
 
 void DataAssignmentProblem::readData() {
-    if (debug) printf("Initialising data for Assignment problem\n\n");
+    if (debug) context->print("Initialising data for Assignment problem\n\n");
 
     numVariables    =  6;
     costs           .resize(numVariables, vector<double>(numVariables));
@@ -61,17 +61,17 @@ void DataAssignmentProblem::readData() {
 
 void DataAssignmentProblem::print() {
     if (debug) {
-        printf("Num variables : %2d\n", numVariables);
+        context->print("Num variables : %2d\n", numVariables);
         for (int i = 0; i < numVariables; i++) {
-            printf("\t Xi%d", i);
+            context->print("\t Xi%d", i);
         }
-        printf("\n");
+        context->print("\n");
         for (int i = 0; i < numVariables; i++) {
-            printf("X%dj", i);
+            context->print("X%dj", i);
             for (int j = 0; j < numVariables; j++) {
-                printf("\t %.2f", costs[i][j]);
+                context->print("\t %.2f", costs[i][j]);
             }
-            printf("\n");
+            context->print("\n");
         }
     }
 
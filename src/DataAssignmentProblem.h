@@ -20,7 +20,7 @@ class DataAssignmentProblem : public Data {
 
     public:
 
-        DataAssignmentProblem();
+        DataAssignmentProblem(RunContext* ctx = NULL);
         virtual ~DataAssignmentProblem();
 
         virtual void readData();
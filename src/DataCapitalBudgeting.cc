@@ -10,7 +10,7 @@
 #include "Options.h"
 
 
-DataCapitalBudgeting::DataCapitalBudgeting() : Data(){
+DataCapitalBudgeting::DataCapitalBudgeting(RunContext* ctx) : Data(ctx){
     numVariables  = 0;
     maxInvestment = 0;
 }
@@ -19,7 +19,7 @@ DataCapitalBudgeting::~DataCapitalBudgeting() {
 }
 
 void DataCapitalBudgeting::readData() {
-    if (debug) printf("Initialising data for capital budgeting problem\n\n");
+    if (debug) context->print("Initialising data for capital budgeting problem\n\n");
 
     numVariables     =  4;
     maxInvestment    = 14;
@@ -40,10 +40,10 @@ void DataCapitalBudgeting::readData() {
 
 void DataCapitalBudgeting::print() {
     if (debug) {
-        printf("Num variables : %2d\n", numVariables);
-        printf("Max investment: %2d\n", maxInvestment);
+        context->print("Num variables : %2d\n", numVariables);
+        context->print("Max investment: %2d\n", maxInvestment);
         for (int i = 0; i < numVariables; i++) {
-            printf(" Inv %2d: Cost %2d, Profit %2d\n", i, initialInvestment[i], futureValue[i]);
+            context->print(" Inv %2d: Cost %2d, Profit %2d\n", i, initialInvestment[i], futureValue[i]);
         }
     }
 
@@ -27,7 +27,7 @@ class DataCapitalBudgeting : public Data {
 
     public:
 
-        DataCapitalBudgeting();
+        DataCapitalBudgeting(RunContext* ctx = NULL);
         virtual ~DataCapitalBudgeting();
 
         virtual void readData();
@@ -3,7 +3,7 @@
 #include "DataConcreteMixerTruckRouting.h"
 #include "Options.h"
 
-DataConcreteMixerTruckRouting::DataConcreteMixerTruckRouting() : Data(){
+DataConcreteMixerTruckRouting::DataConcreteMixerTruckRouting(RunContext* ctx) : Data(ctx){
     numberOfConstructions = 0;
     concreteMixerTruckFleet = 0;
     numberOfTypesOfConcrete = 0;
@@ -13,10 +13,10 @@ DataConcreteMixerTruckRouting::~DataConcreteMixerTruckRouting() {
 }
 
 void DataConcreteMixerTruckRouting::readData() {
-    if (debug) printf("Initializing data for Concrete Mixer Routing \n\n");
+    if (debug) context->print("Initializing data for Concrete Mixer Routing \n\n");
 
     FILE* file;
-    string inputFilename = Options::getInstance()->getStringOption("input");
+    string inputFilename = context->getOptions()->getStringOption("input");
     string fourLastCharacters = inputFilename.substr(inputFilename.length() - 4);
     string availableSuffix = ".txt";
 
@@ -102,32 +102,59 @@ void DataConcreteMixerTruckRouting::readData() {
 
     // close file
     if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: Instances file %s could not be closed.", inputFilename.c_str());
+
+    computeAdmissibleArcs();
+}
+
+// An arc (i, j) is admissible unless no route can use it: a truck carries a single type of concrete, so it
+// never goes between clients of different types. Deliveries may be split among trucks, so capacity alone
+// rules out no arc. If max_arc_distance is set, arcs between clients farther apart are dropped too, which
+// may cut off optimal routes. Arcs to and from the depot are always kept, so every client can be served.
+void DataConcreteMixerTruckRouting::computeAdmissibleArcs() {
+    int V = numberOfConstructions + 1;
+    double maxDistance = context->getOptions()->getDoubleOption("max_arc_distance");
+
+    admissible.assign(V, vector<char>(V, 0));
+    admissibleArcs.clear();
+    for (int i = 0; i < V; i++) {
+        for (int j = 0; j < V; j++) {
+            if (i == j) continue;
+            if (i != 0 && j != 0) {
+                if (demands[i].getConcreteTypeId(i) != demands[j].getConcreteTypeId(j)) continue;
+                if (maxDistance > 0 && distances[i][j] > maxDistance) continue;
+            }
+            admissible[i][j] = 1;
+            admissibleArcs.push_back(std::make_pair(i, j));
+        }
+    }
+
+    if (debug) context->print("Admissible arcs: %d of %d\n\n", (int)admissibleArcs.size(), V * (V - 1));
 }
 
 void DataConcreteMixerTruckRouting::print() {
     if (debug) {
-        printf("number of constructions\n");
-        printf("%d\n\n", numberOfConstructions);
-        printf("concrete mixer truck fleet\n");
-        printf("%d\n\n", concreteMixerTruckFleet);
-        printf("number of types of concrete\n");
-        printf("%d\n\n", numberOfTypesOfConcrete);
-        printf("fixed cost of using the concrete mixer truck\n");
-        printf("R$%.2f\n\n", fixedCost);
-        printf("concrete mixer truck capacity\n");
-        printf("%.2f\n\n", concreteMixerTruckCapacity);
-        printf("demands\n");
+        context->print("number of constructions\n");
+        context->print("%d\n\n", numberOfConstructions);
+        context->print("concrete mixer truck fleet\n");
+        context->print("%d\n\n", concreteMixerTruckFleet);
+        context->print("number of types of concrete\n");
+        context->print("%d\n\n", numberOfTypesOfConcrete);
+        context->print("fixed cost of using the concrete mixer truck\n");
+        context->print("R$%.2f\n\n", fixedCost);
+        context->print("concrete mixer truck capacity\n");
+        context->print("%.2f\n\n", concreteMixerTruckCapacity);
+        context->print("demands\n");
         for (int i = 0; i <= numberOfConstructions; i++) {
-            printf("demandId: %d\t quantity: %.2f\t concreteTypeId: %2d\n", demands[i].constructionId, demands[i].getQuantity(demands[i].constructionId), demands[i].getConcreteTypeId(demands[i].constructionId));
+            context->print("demandId: %d\t quantity: %.2f\t concreteTypeId: %2d\n", demands[i].constructionId, demands[i].getQuantity(demands[i].constructionId), demands[i].getConcreteTypeId(demands[i].constructionId));
         }
-        printf("\ndistances\n");
+        context->print("\ndistances\n");
         for (int i = 0; i <= numberOfConstructions; i++) {
             for (int j = 0; j <= numberOfConstructions; j++) {
-                printf("%.2f\t", distances[i][j]);
+                context->print("%.2f\t", distances[i][j]);
             }
-            printf("\n");
+            context->print("\n");
         }
-        printf("\n");
+        context->print("\n");
     }
 
 }
@@ -142,3 +169,9 @@ double DataConcreteMixerTruckRouting::getDistance(int i, int j) const {
     if (j >= numberOfConstructions + 1) Util::throwInvalidArgument("Error: Out of range parameter j in getDistance");
     return distances[i][j];
 }
+
+bool DataConcreteMixerTruckRouting::isArcAdmissible(int i, int j) const {
+    if (i >= numberOfConstructions + 1) Util::throwInvalidArgument("Error: Out of range parameter i in isArcAdmissible");
+    if (j >= numberOfConstructions + 1) Util::throwInvalidArgument("Error: Out of range parameter j in isArcAdmissible");
+    return admissible[i][j];
+}
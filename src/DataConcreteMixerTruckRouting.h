@@ -42,9 +42,15 @@ class DataConcreteMixerTruckRouting : public Data {
         vector<ClientDemand> demands;
         vector<vector<double>> distances;
 
+        // Arcs a truck may travel, see computeAdmissibleArcs
+        vector<vector<char>> admissible;
+        vector<std::pair<int, int>> admissibleArcs;
+
+        void computeAdmissibleArcs();
+
     public:
 
-        DataConcreteMixerTruckRouting();
+        DataConcreteMixerTruckRouting(RunContext* ctx = NULL);
         virtual ~DataConcreteMixerTruckRouting();
 
         virtual void readData();
@@ -57,6 +63,8 @@ class DataConcreteMixerTruckRouting : public Data {
         double       getConcreteMixerTruckCapacity  (            ) const {return concreteMixerTruckCapacity;}
         ClientDemand getDemand                      (int i       ) const ;
         double       getDistance                    (int i, int j) const ;
+        bool         isArcAdmissible                (int i, int j) const ;
+        const vector<std::pair<int, int>>& getAdmissibleArcs() const {return admissibleArcs;}
 };
 
 #endif
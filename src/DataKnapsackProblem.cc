@@ -3,7 +3,7 @@
 #include "Options.h"
 
 
-DataKnapsackProblem::DataKnapsackProblem() : Data(){
+DataKnapsackProblem::DataKnapsackProblem(RunContext* ctx) : Data(ctx){
     numVariables  = 0;
     capacity = 0;
 }
@@ -12,7 +12,7 @@ DataKnapsackProblem::~DataKnapsackProblem() {
 }
 
 void DataKnapsackProblem::readData() {
-    if (debug) printf("Initialising data for knapsack problem\n\n");
+    if (debug) context->print("Initialising data for knapsack problem\n\n");
 
     numVariables     = 10;
     capacity         = 10;
@@ -44,10 +44,10 @@ void DataKnapsackProblem::readData() {
 
 void DataKnapsackProblem::print() {
     if (debug) {
-        printf("Num variables : %2d\n", numVariables);
-        printf("Capacity: %f\n", capacity);
+        context->print("Num variables : %2d\n", numVariables);
+        context->print("Capacity: %f\n", capacity);
         for (int i = 0; i < numVariables; i++) {
-            printf("Item %2d: Cost %f, Return value %f\n", i, costs[i], returnValues[i]);
+            context->print("Item %2d: Cost %f, Return value %f\n", i, costs[i], returnValues[i]);
         }
     }
 }
@@ -20,7 +20,7 @@ class DataKnapsackProblem : public Data {
 
     public:
 
-        DataKnapsackProblem();
+        DataKnapsackProblem(RunContext* ctx = NULL);
         virtual ~DataKnapsackProblem();
 
         virtual void readData();
@@ -3,7 +3,7 @@
 #include "Options.h"
 
 
-DataMotivatingProblem::DataMotivatingProblem() : Data(){
+DataMotivatingProblem::DataMotivatingProblem(RunContext* ctx) : Data(ctx){
     numVariables  = 0;
     firstConstraintMaxValue = 0;
     secondConstraintMaxValue = 0;
@@ -14,7 +14,7 @@ DataMotivatingProblem::~DataMotivatingProblem() {
 }
 
 void DataMotivatingProblem::readData() {
-    if (debug) printf("Initialising data for motivating problem problem\n\n");
+    if (debug) context->print("Initialising data for motivating problem problem\n\n");
 
     numVariables                = 2;
     objectiveCoefficients       .resize(numVariables);
@@ -43,47 +43,47 @@ void DataMotivatingProblem::readData() {
 
 void DataMotivatingProblem::print() {
     if (debug) {
-        printf("Num variables : %2d\n", numVariables);
-        printf("Model: \n");
+        context->print("Num variables : %2d\n", numVariables);
+        context->print("Model: \n");
 
         // Objective function
         for (int i = 0; i < numVariables; i++) {
             if(i == 0){
-                printf("max %2d x%d + ", objectiveCoefficients[i], i+1);
+                context->print("max %2d x%d + ", objectiveCoefficients[i], i+1);
             } else if (i == numVariables - 1) {
-                printf("%2d x%d \n", objectiveCoefficients[i], i+1);
+                context->print("%2d x%d \n", objectiveCoefficients[i], i+1);
             } else {
-                printf("%2d x%d + ", objectiveCoefficients[i], i+1);
+                context->print("%2d x%d + ", objectiveCoefficients[i], i+1);
             }
         }
 
         // Constraints
-        printf("s.t. \n");
+        context->print("s.t. \n");
 
         // First constraint
         for (int i = 0; i < numVariables; i++) {
             if (i == numVariables - 1) {
-                printf("%2d x%d <= %2d \n", firstConstraintCoefficients[i], i+1, firstConstraintMaxValue);
+                context->print("%2d x%d <= %2d \n", firstConstraintCoefficients[i], i+1, firstConstraintMaxValue);
             } else {
-                printf("%2d x%d + ", firstConstraintCoefficients[i], i+1);
+                context->print("%2d x%d + ", firstConstraintCoefficients[i], i+1);
             }
         }
 
         // Second constraint
         for (int i = 0; i < numVariables; i++) {
             if (i == numVariables - 1) {
-                printf("%2d x%d <= %2d \n", secondConstraintCoefficients[i], i+1, secondConstraintMaxValue);
+                context->print("%2d x%d <= %2d \n", secondConstraintCoefficients[i], i+1, secondConstraintMaxValue);
             } else {
-                printf("%2d x%d + ", secondConstraintCoefficients[i], i+1);
+                context->print("%2d x%d + ", secondConstraintCoefficients[i], i+1);
             }
         }
 
         // Third constraint
         for (int i = 0; i < numVariables; i++) {
             if (i == numVariables - 1) {
-                printf("%2d x%d <= %2d \n", thirdConstraintCoefficients[i], i+1, thirdConstraintMaxValue);
+                context->print("%2d x%d <= %2d \n", thirdConstraintCoefficients[i], i+1, thirdConstraintMaxValue);
             } else {
-                printf("%2d x%d + ", thirdConstraintCoefficients[i], i+1);
+                context->print("%2d x%d + ", thirdConstraintCoefficients[i], i+1);
             }
         }
     }
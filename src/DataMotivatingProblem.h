@@ -28,7 +28,7 @@ class DataMotivatingProblem : public Data {
 
     public:
 
-        DataMotivatingProblem();
+        DataMotivatingProblem(RunContext* ctx = NULL);
         virtual ~DataMotivatingProblem();
 
         virtual void readData();
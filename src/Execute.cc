@@ -19,7 +19,8 @@
 #include "DataConcreteMixerTruckRouting.h"
 #include "ModelConcreteMixerTruckRouting.h"
 
-Execute::Execute() {
+Execute::Execute(RunContext* ctx) {
+    context = ctx ? ctx : RunContext::getDefault();
     totalTime = 0;
     model = NULL;
     data  = NULL;
@@ -33,25 +34,33 @@ Execute::~Execute() {
 
 void Execute::execute() {
     float startTime = Util::getTime();
+
+    string replayFile = context->getOptions()->getStringOption("replay_trace");
+    if (!replayFile.empty()) {
+        model = new Model(context);
+        model->replayTrace(replayFile);
+        totalTime = Util::getTime() - startTime;
+        return;
+    }
      
-    if (Options::getInstance()->getStringOption("model").compare("toy") == 0) {
-        data  = new DataCapitalBudgeting();
-        model = new ModelCapitalBudgeting();
-    } else if (Options::getInstance()->getStringOption("model").compare("motivating") == 0) {
-        data  = new DataMotivatingProblem();
-        model = new ModelMotivatingProblem();
-    } else if (Options::getInstance()->getStringOption("model").compare("knapsackProblem") == 0) {
-        data  = new DataKnapsackProblem();
-        model = new ModelKnapsackProblem();
-    } else if (Options::getInstance()->getStringOption("model").compare("assignmentProblem") == 0) {
-        data  = new DataAssignmentProblem();
-        model = new ModelAssignmentProblem();
-    } else if (Options::getInstance()->getStringOption("model").compare("concreteMixerTruckRouting") == 0) {
-        data  = new DataConcreteMixerTruckRouting();
-        model = new ModelConcreteMixerTruckRouting();
+    if (context->getOptions()->getStringOption("model").compare("toy") == 0) {
+        data  = new DataCapitalBudgeting(context);
+        model = new ModelCapitalBudgeting(context);
+    } else if (context->getOptions()->getStringOption("model").compare("motivating") == 0) {
+        data  = new DataMotivatingProblem(context);
+        model = new ModelMotivatingProblem(context);
+    } else if (context->getOptions()->getStringOption("model").compare("knapsackProblem") == 0) {
+        data  = new DataKnapsackProblem(context);
+        model = new ModelKnapsackProblem(context);
+    } else if (context->getOptions()->getStringOption("model").compare("assignmentProblem") == 0) {
+        data  = new DataAssignmentProblem(context);
+        model = new ModelAssignmentProblem(context);
+    } else if (context->getOptions()->getStringOption("model").compare("concreteMixerTruckRouting") == 0) {
+        data  = new DataConcreteMixerTruckRouting(context);
+        model = new ModelConcreteMixerTruckRouting(context);
     } else {
-        data  = new Data();
-        model = new Model();
+        data  = new Data(context);
+        model = new Model(context);
     }
     
     data->readData();
@@ -61,9 +70,15 @@ void Execute::execute() {
     model->printSolution();
      
     totalTime = Util::getTime() - startTime;
+
+    context->setCounter("total_time",   totalTime);
+    context->setCounter("solving_time", model->getSolvingTime());
+    context->setCounter("nodes",        model->getTotalNodes());
+    context->setCounter("objective",    model->getSolution()->getValue());
+    context->setCounter("cuts_added",   model->getCutsAdded());
     
     /*
-    if (Options::getInstance()->getIntOption("debug")) {
+    if (context->getOptions()->getIntOption("debug")) {
         printf("\n");
         printf("Solution value:           %8.2f\n",   model->getSolution().getValue());
         printf("Final lower bound:        %8.2f\n",   model->getSolution().getBestBound());
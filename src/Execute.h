@@ -16,6 +16,8 @@ class Execute {
 
     private:
 
+        RunContext* context;
+
         Data* data;
 
         Model* model;
@@ -24,7 +26,8 @@ class Execute {
 
     public:
    
-        Execute();
+        // Runs with the options and output of ctx, the default context if NULL
+        Execute(RunContext* ctx = NULL);
         ~Execute();
 
         void execute();
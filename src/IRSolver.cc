@@ -0,0 +1,109 @@
+/**
+ * IRSolver.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "IRSolver.h"
+
+// Names are only generated when the IR is loaded into a solver (or a name is looked up)
+IRSolver::IRSolver(ModelIR& modelIR) : Solver(), ir(modelIR) {
+    useNames = false;
+}
+
+IRSolver::~IRSolver() {
+}
+
+void IRSolver::setColNames(int firstCol, int numCols, NameFormatter format) {
+    if (numCols <= 0) return;
+    Solver::setColNames(firstCol, numCols, format);
+    ir.addColFormatter(firstCol, numCols, format);
+}
+
+void IRSolver::setRowNames(int firstRow, int numRows, NameFormatter format) {
+    if (numRows <= 0) return;
+    Solver::setRowNames(firstRow, numRows, format);
+    ir.addRowFormatter(firstRow, numRows, format);
+}
+
+void IRSolver::changeObjectiveSense(bool isMax) {
+    ir.setMaximisation(isMax);
+}
+
+int IRSolver::addColumns(int numCols, const double* obj, double lower, double upper, char type) {
+    int firstCol = getNumCols();
+    vector<double> lo(numCols, lower);
+    vector<double> up(numCols, upper);
+    ir.addColumns(numCols, obj, &lo[0], &up[0], type);
+    return firstCol;
+}
+
+int IRSolver::addVariable(const double lower, const double upper, const double obj, string name) {
+    int col = addColumns(1, &obj, lower, upper, 'C');
+    if (!name.empty()) {
+        addKey(name, col);
+        ir.addColName(col, name);
+    }
+    return col;
+}
+
+int IRSolver::addVariables(int numCols, const double lower, const double upper, const double* obj, string& name) {
+    int firstCol = addColumns(numCols, obj, lower, upper, 'C');
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
+
+int IRSolver::addBinaryVariable(const double obj, string name) {
+    int col = addColumns(1, &obj, 0.0, 1.0, 'B');
+    if (!name.empty()) {
+        addKey(name, col);
+        ir.addColName(col, name);
+    }
+    return col;
+}
+
+int IRSolver::addBinaryVariables(int numCols, const double* obj, string& name) {
+    int firstCol = addColumns(numCols, obj, 0.0, 1.0, 'B');
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
+
+int IRSolver::addIntegerVariable(const double lower, const double upper, const double obj, string name) {
+    int col = addColumns(1, &obj, lower, upper, 'I');
+    if (!name.empty()) {
+        addKey(name, col);
+        ir.addColName(col, name);
+    }
+    return col;
+}
+
+int IRSolver::addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name) {
+    int firstCol = addColumns(numCols, obj, lb, ub, 'I');
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
+
+void IRSolver::addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
+    int numNonZero = (int)colNames.size();
+
+    vector<int> colIndices(numNonZero);
+    for (int i = 0; i < numNonZero; i++) {
+        colIndices[i] = getColIndex(colNames[i]);
+        if (colIndices[i] == -1) Util::throwInvalidArgument("Error: In addRow, column %s was not found.", colNames[i].c_str());
+    }
+
+    addRow(numNonZero, colIndices.data(), elements.data(), rhs, sense, name);
+}
+
+void IRSolver::addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    if (sense != 'L' && sense != 'E' && sense != 'G') 
+        Util::throwInvalidArgument("Error: In addRow, invalid sense %c (valid values are 'L', 'E' and 'G').", sense);
+    if (!name.empty()) ir.addRowName(getNumRows(), name);
+    ir.addRow(numNonZero, colIndices, elements, rhs, sense);
+}
+
+void IRSolver::printSolverName() {
+    printf("Model IR builder assigned\n");
+}
@@ -0,0 +1,53 @@
+/**
+ * IRSolver.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef IRSOLVER_H
+#define IRSOLVER_H
+
+#include "Solver.h"
+
+/**
+ * Solver that does not solve anything, it records the model into a ModelIR.
+ *
+ * Models build themselves through it exactly as they would through any other solver,
+ * column names are resolved as usual. The IR can then be loaded into other solvers.
+ */
+class IRSolver : public Solver {
+
+    private:
+
+        ModelIR& ir;
+
+        int addColumns(int numCols, const double* obj, double lower, double upper, char type);
+
+    public:
+
+        IRSolver(ModelIR& modelIR);
+        ~IRSolver();
+
+        virtual void setColNames(int firstCol, int numCols, NameFormatter format);
+        virtual void setRowNames(int firstRow, int numRows, NameFormatter format);
+
+        virtual void changeObjectiveSense(bool isMax);
+        virtual int addVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addVariables(int numCols, const double lower, const double upper, const double* obj, string& name);
+        virtual int addBinaryVariable(const double obj, string name);
+        virtual int addBinaryVariables(int numCols, const double* obj, string& name);
+        virtual int addIntegerVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name);
+        virtual void addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
+
+        virtual int getNumCols() { return ir.getNumCols(); }
+        virtual int getNumRows() { return ir.getNumRows(); }
+        virtual int isMIP()      { return ir.isMIP();      }
+
+        virtual void printSolverName();
+};
+
+#endif
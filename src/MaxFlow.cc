@@ -0,0 +1,254 @@
+/**
+ * MaxFlow.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "MaxFlow.h"
+
+#define MAXFLOW_TOLERANCE 1e-9
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+MaxFlow::MaxFlow() {
+    numNodes  = 0;
+    numArcs   = 0;
+    highest   = -1;
+    relabelsSinceGlobal = 0;
+    source    = -1;
+    sink      = -1;
+    warm      = false;
+    tolerance = MAXFLOW_TOLERANCE;
+    first.push_back(0);
+}
+
+MaxFlow::~MaxFlow() {
+}
+
+void MaxFlow::reset(int n) {
+    numNodes = n;
+    numArcs  = 0;
+    tails.clear();
+    heads.clear();
+    capacities.clear();
+    first.assign(n + 1, 0);
+    head.clear();
+    reverse.clear();
+    capacity.clear();
+    residual.clear();
+    arcPosition.clear();
+    warm = false;
+}
+
+int MaxFlow::addArc(int tail, int h, double c) {
+    if (tail < 0 || tail >= numNodes || h < 0 || h >= numNodes)
+        Util::throwInvalidArgument("Error in addArc: Arc (%d, %d) out of range (%d nodes).", tail, h, numNodes);
+    tails.push_back(tail);
+    heads.push_back(h);
+    capacities.push_back(c);
+    return numArcs++;
+}
+
+void MaxFlow::build() {
+    first.assign(numNodes + 1, 0);
+    for (int i = 0; i < numArcs; i++) {
+        first[tails[i] + 1]++;
+        first[heads[i] + 1]++;
+    }
+    for (int v = 0; v < numNodes; v++) first[v + 1] += first[v];
+
+    int size = 2 * numArcs;
+    head.resize(size);
+    reverse.resize(size);
+    capacity.resize(size);
+    residual.resize(size);
+    arcPosition.resize(numArcs);
+
+    vector<int> next(first.begin(), first.end() - 1);
+    for (int i = 0; i < numArcs; i++) {
+        int forward  = next[tails[i]]++;
+        int backward = next[heads[i]]++;
+        head[forward]      = heads[i];
+        head[backward]     = tails[i];
+        reverse[forward]   = backward;
+        reverse[backward]  = forward;
+        capacity[forward]  = capacities[i];
+        capacity[backward] = 0;
+        arcPosition[i]     = forward;
+    }
+
+    excess.assign(numNodes, 0);
+    label.assign(numNodes, numNodes);
+    current.assign(numNodes, 0);
+    buckets.assign(numNodes, vector<int>());
+    labelCount.assign(numNodes, 0);
+    inBucket.assign(numNodes, 0);
+    resetFlow();
+}
+
+void MaxFlow::setCapacity(int arc, double c) {
+    int a = arcPosition[arc];
+    double flow = capacity[a] - residual[a];
+    if (flow > c + tolerance) warm = false;
+    capacity[a] = c;
+    residual[a] = std::max(0.0, c - flow);
+}
+
+void MaxFlow::resetFlow() {
+    residual = capacity;
+    std::fill(excess.begin(), excess.end(), 0.0);
+    warm = true;
+}
+
+/**
+ * PUSH-RELABEL
+ *
+ */
+
+double MaxFlow::solve(int s, int t) {
+    if (s == t || s < 0 || s >= numNodes || t < 0 || t >= numNodes)
+        Util::throwInvalidArgument("Error in solve: Invalid source %d and sink %d (%d nodes).", s, t, numNodes);
+    if (!warm || s != source) resetFlow();
+    source = s;
+    sink   = t;
+
+    for (int a = first[s]; a < first[s + 1]; a++) {
+        if (residual[a] > tolerance) push(a, residual[a]);
+    }
+    globalRelabel();
+
+    while (highest >= 0) {
+        if (buckets[highest].empty()) {
+            highest--;
+            continue;
+        }
+        int v = buckets[highest].back();
+        buckets[highest].pop_back();
+        inBucket[v] = 0;
+        // Nodes cut off by a gap stay in their bucket
+        if (label[v] >= numNodes || excess[v] <= tolerance) continue;
+
+        discharge(v);
+        if (relabelsSinceGlobal >= numNodes) globalRelabel();
+    }
+    return excess[t];
+}
+
+void MaxFlow::push(int a, double delta) {
+    residual[a]          -= delta;
+    residual[reverse[a]] += delta;
+    excess[head[reverse[a]]] -= delta;
+    excess[head[a]]          += delta;
+}
+
+void MaxFlow::activate(int v) {
+    if (inBucket[v] || v == source || v == sink || label[v] >= numNodes || excess[v] <= tolerance) return;
+    buckets[label[v]].push_back(v);
+    inBucket[v] = 1;
+    highest = std::max(highest, label[v]);
+}
+
+// Pushes the whole excess of v, relabelling it as needed, unless it can no longer reach the sink
+void MaxFlow::discharge(int v) {
+    while (excess[v] > tolerance) {
+        if (current[v] == first[v + 1]) {
+            relabel(v);
+            if (label[v] >= numNodes) return;
+            continue;
+        }
+
+        int a = current[v];
+        int w = head[a];
+        if (residual[a] > tolerance && label[v] == label[w] + 1) {
+            push(a, std::min(excess[v], residual[a]));
+            activate(w);
+        } else {
+            current[v]++;
+        }
+    }
+}
+
+void MaxFlow::relabel(int v) {
+    int old = label[v];
+    int newLabel = numNodes;
+    for (int a = first[v]; a < first[v + 1]; a++) {
+        if (residual[a] > tolerance) newLabel = std::min(newLabel, label[head[a]] + 1);
+    }
+
+    relabelsSinceGlobal++;
+    current[v] = first[v];
+    if (--labelCount[old] == 0) {
+        gap(old);
+        label[v] = numNodes;
+        return;
+    }
+    label[v] = std::min(newLabel, numNodes);
+    if (label[v] < numNodes) labelCount[label[v]]++;
+}
+
+// No node is left with emptyLabel, so none above it can reach the sink
+void MaxFlow::gap(int emptyLabel) {
+    for (int u = 0; u < numNodes; u++) {
+        if (label[u] > emptyLabel && label[u] < numNodes) {
+            labelCount[label[u]]--;
+            label[u] = numNodes;
+        }
+    }
+}
+
+// Labels become the exact distances to the sink in the residual graph
+void MaxFlow::globalRelabel() {
+    std::fill(label.begin(), label.end(), numNodes);
+    std::fill(labelCount.begin(), labelCount.end(), 0);
+    label[sink] = 0;
+    labelCount[0] = 1;
+
+    queue.clear();
+    queue.push_back(sink);
+    for (unsigned q = 0; q < queue.size(); q++) {
+        int w = queue[q];
+        for (int a = first[w]; a < first[w + 1]; a++) {
+            int u = head[a];
+            if (label[u] < numNodes || u == source || residual[reverse[a]] <= tolerance) continue;
+            label[u] = label[w] + 1;
+            labelCount[label[u]]++;
+            queue.push_back(u);
+        }
+    }
+
+    for (auto& bucket : buckets) bucket.clear();
+    std::fill(inBucket.begin(), inBucket.end(), 0);
+    highest = -1;
+    for (int v = 0; v < numNodes; v++) {
+        current[v] = first[v];
+        activate(v);
+    }
+    relabelsSinceGlobal = 0;
+}
+
+/**
+ * MINIMUM CUT
+ *
+ */
+
+int MaxFlow::getSinkSide(vector<char>& sinkSide) {
+    sinkSide.assign(numNodes, 0);
+    sinkSide[sink] = 1;
+    queue.clear();
+    queue.push_back(sink);
+    for (unsigned q = 0; q < queue.size(); q++) {
+        int w = queue[q];
+        for (int a = first[w]; a < first[w + 1]; a++) {
+            int u = head[a];
+            if (sinkSide[u] || residual[reverse[a]] <= tolerance) continue;
+            sinkSide[u] = 1;
+            queue.push_back(u);
+        }
+    }
+    return (int)queue.size();
+}
@@ -0,0 +1,100 @@
+/**
+ * MaxFlow.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+#include "Util.h"
+
+/**
+ * Maximum flow and minimum cut by push-relabel, processing the active node of highest label first and
+ * using the gap heuristic and periodic global relabelling.
+ *
+ * The graph is given arc by arc (addArc) and frozen into CSR form by build, after which only the
+ * capacities may change. Each arc is stored along with its reverse, the residual graph is kept from
+ * one solve to the next: as long as the source is the same and no capacity fell below the flow on
+ * its arc, the flow of the previous solve is the starting preflow of the next. Solving from one source
+ * to many sinks in a row (as in the separation of connectivity cuts) thus reuses most of the work.
+ *
+ * Only the first phase of the algorithm is run, so at the end there is a maximum preflow rather than
+ * a flow, which is all the minimum cut needs.
+ */
+class MaxFlow {
+
+    private:
+
+        int numNodes;
+        int numArcs;
+
+        // Arcs as given, turned into the CSR arrays below by build
+        vector<int>    tails;
+        vector<int>    heads;
+        vector<double> capacities;
+
+        // Residual graph: arcs of node v are [first[v], first[v + 1]), arc a goes to head[a] and reverse[a]
+        // is its reverse. arcPosition maps the arcs as given to their position
+        vector<int>    first;
+        vector<int>    head;
+        vector<int>    reverse;
+        vector<double> capacity;
+        vector<double> residual;
+        vector<int>    arcPosition;
+
+        vector<double> excess;
+        vector<int>    label;
+        vector<int>    current;
+        // Active nodes by label, and number of nodes with each label below numNodes
+        vector<vector<int>> buckets;
+        vector<int>    labelCount;
+        vector<char>   inBucket;
+        vector<int>    queue;
+        int highest;
+        int relabelsSinceGlobal;
+
+        int source;
+        int sink;
+        bool warm;
+        double tolerance;
+
+        void push(int a, double delta);
+        void activate(int v);
+        void discharge(int v);
+        void relabel(int v);
+        void gap(int emptyLabel);
+        void globalRelabel();
+        void resetFlow();
+
+    public:
+
+        MaxFlow();
+        ~MaxFlow();
+
+        // Starts a new graph with numNodes nodes and no arcs
+        void reset(int numNodes);
+        // Returns the index of the arc, valid once the graph is built
+        int  addArc(int tail, int head, double capacity);
+        void build();
+
+        void setCapacity(int arc, double capacity);
+        // Residual capacities below this are taken as zero
+        void setTolerance(double t) { tolerance = t; }
+
+        // Returns the value of a maximum flow from source to sink
+        double solve(int source, int sink);
+        // Nodes on the sink side of a minimum cut of the last solve, i.e. those that can still reach the
+        // sink in the residual graph (the smallest such side). Returns how many
+        int getSinkSide(vector<char>& sinkSide);
+        double getFlow(int arc) { return capacity[arcPosition[arc]] - residual[arcPosition[arc]]; }
+
+        int getNumNodes() { return numNodes; }
+        int getNumArcs()  { return numArcs;  }
+        int getTail(int arc) { return tails[arc]; }
+        int getHead(int arc) { return heads[arc]; }
+};
+
+#endif
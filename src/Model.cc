@@ -7,23 +7,49 @@
  */
 
 #include "Model.h"
+#ifdef USE_CPLEX
 #include "CPLEX.h"
+#include "CPLEXEnvPool.h"
+#endif
+#include "Simplex.h"
+#include "BranchAndBound.h"
+#include "RecordingSolver.h"
+#include "IRSolver.h"
+#include "SolverRace.h"
+#include "SolveHandle.h"
 #include "Options.h"
+#include <thread>
+
+#define INFO_CALLBACK      1
+#define LAZY_CALLBACK      2
+#define USER_CUT_CALLBACK  4
+#define INCUMBENT_CALLBACK 8
+
+// Relative gap at which a race is stopped
+#define RACE_GAP 1e-4
+// Seconds between checks of whether the incumbent is good enough
+#define POLL_INTERVAL 0.05
+
+// Identifies models to the threads that cache their statistics slot
+static std::atomic<unsigned long> nextModelId(1);
 
 /**
  * INITIAL METHODS
  *
  */
 
-Model::Model() {
-    string solverUsed = Options::getInstance()->getStringOption("solver");
-    
-    if (solverUsed.compare("cplex") == 0) {
-        solver = new CPLEX();
-    } else {
-        solver = new Solver();
+Model::Model(RunContext* ctx) {
+    context = ctx ? ctx : RunContext::getDefault();
+    solver  = createSolver();
+
+    string traceFile = context->getOptions()->getStringOption("trace_file");
+    recorder = NULL;
+    if (!traceFile.empty()) {
+        recorder = dynamic_cast<RecordingSolver*>(solver);
+        if (!recorder) solver = recorder = new RecordingSolver(solver);
+        recorder->setTraceFile(traceFile);
     }
-    solution = new Solution();
+    solution = new Solution(context);
 
     isMax = 1;
 
@@ -46,10 +72,12 @@ Model::Model() {
     callbackCalls       = 0;
     maxFlowCalls        = 0;
     cutsAdded           = 0;
+    poolCuts            = 0;
+    duplicateCuts       = 0;
 
     bestSolutionTime  = 0;
     bestSolutionNodes = 0;
-    bestSolutionSoFar = -10000000;   
+    bestSolutionSoFar = 0;
 
     firstNodeTime     = 0;
     firstNodeBound    = 0;
@@ -57,39 +85,211 @@ Model::Model() {
 
     totalNodes        = 0;
 
-    goodEnoughSolution = 0;
+    goodEnoughSolution = context->getOptions()->getDoubleOption("good_enough_solution");
+    cutPool.setMaxAge(context->getOptions()->getIntOption("cut_pool_age"));
     
     counter = 0;
-    debug = Options::getInstance()->getIntOption("debug");
-    timeLimit = (double)Options::getInstance()->getIntOption("time_limit");
+    debug = context->getOptions()->getIntOption("debug");
+    timeLimit = (double)context->getOptions()->getIntOption("time_limit");
 
     captureCuts = 0;
+    callbacks   = 0;
+    parallelCallbacks = false;
+    id          = nextModelId++;
+    raceProved  = false;
+    raceBounded = false;
+    raceBound   = 0;
 }
 
 
 Model::~Model() {
     delete(solver);
     delete(solution);
+    for (CallbackStats* stats : callbackStats) delete(stats);
+}
+
+Solver* Model::createSolver() {
+    string solverUsed = context->getOptions()->getStringOption("solver");
+    Solver* s;
+    
+#ifdef USE_CPLEX
+    if (solverUsed.compare("cplex") == 0) {
+        CPLEXEnvPool::getInstance()->setMaxIdle(context->getOptions()->getIntOption("cplex_env_pool"));
+        s = new CPLEX();
+    } else
+#endif
+    if (solverUsed.compare("simplex") == 0) {
+        s = new Simplex();
+    } else if (solverUsed.compare("native") == 0) {
+        s = new BranchAndBound();
+    } else if (solverUsed.compare("record") == 0) {
+        s = new RecordingSolver();
+    } else {
+        s = new Solver();
+    }
+    s->setNamesEnabled(context->getOptions()->getBoolOption("solver_names"));
+    return s;
 }
 
 void Model::overrideDebug(int d) {
     debug = d;
 }
 
+/**
+ * Creates the model into the IR and loads it into the solver in one shot or, if model_ir is 
+ * disabled, directly into the solver within a build transaction (columns and rows added in bulk)
+ */
+void Model::buildModel(const Data* data) {
+    if (!context->getOptions()->getBoolOption("model_ir")) {
+        int bufferMB = context->getOptions()->getIntOption("build_buffer_mb");
+        if (bufferMB > 0) solver->beginBuild((size_t)bufferMB * 1024 * 1024);
+        createModel(data);
+        solver->endBuild();
+        return;
+    }
+
+    ir.clear();
+    Solver*  backend = solver;
+    IRSolver builder(ir);
+    solver = &builder;
+    try {
+        createModel(data);
+    } catch (...) {
+        solver = backend;
+        throw;
+    }
+    solver = backend;
+
+    if (debug > 1) ir.printStatistics();
+    solver->loadModel(ir);
+}
+
 void Model::solve(const Data* data) {
 
-    solverStartTime = Util::getWallTime();
-    //solver->relax();
-    solver->solve();
+    if (debug > 1 && solver->getNumCols() > 0) {
+        context->print("Column names use %.2f KB (%.1f bytes per column)\n", 
+               solver->getColNamesMemoryUsage() / 1024.0, (double)solver->getColNamesMemoryUsage() / solver->getNumCols());
+    }
+
+    solverStartTime   = Util::getWallTime();
+    bestSolutionSoFar = isMax ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    bool relaxed = context->getOptions()->getBoolOption("lp_relaxation");
+    if (relaxed) solver->relax();
+
+    int numSolvers = context->getOptions()->getIntOption("portfolio_workers");
+    if (numSolvers > 1 && !relaxed && !captureCuts && solver->isMIP()) solveRace(numSolvers);
+    else if (goodEnoughSolution != 0)                                  solveUntilGoodEnough();
+    else                                                               solver->solve();
     solvingTime = Util::getWallTime() - solverStartTime;
+    mergeCallbackStats();
 
-    if (debug > 1) printf("\n---------\n");
-    if (debug > 1) printf("Model solved in %.2fs, status = %d\n", solvingTime, solver->getStatus());
+    if (debug > 1) context->print("\n---------\n");
+    if (debug > 1) context->print("Model solved in %.2fs, status = %d\n", solvingTime, solver->getStatus());
+    if (debug > 1 && callbackCalls > 0) context->print("Separation called %d times, %d cuts in %.3fs\n", callbackCalls, cutsAdded, callbackTime);
+    if (debug > 1 && cutPool.isEnabled() && callbackCalls > 0) 
+        context->print("Cut pool: %d cuts pooled, %d cuts reused, %d duplicates dropped\n", cutPool.getNumCuts(), poolCuts, duplicateCuts);
 
     readSolution(data);
 
+    // The solver holding the best solution may have been stopped by the race before proving it, and
+    // its bound may not be the best one
+    if (raceProved) {
+        solution->setSolutionStatus(true, true, false, false);
+        solution->setBestBound(solution->getValue());
+    } else if (raceBounded && solver->solutionExists()) {
+        double bound = solution->getBestBound();
+        if (isMax ? raceBound < bound : raceBound > bound) solution->setBestBound(raceBound);
+    }
 }  
 
+// Stops the solver as soon as its incumbent is good enough
+void Model::solveUntilGoodEnough() {
+    SolveHandle* handle = solver->solveAsync();
+    try {
+        while (!handle->waitFor(POLL_INTERVAL)) {
+            if (!handle->isCancelled() && handle->hasIncumbent() && isSolutionGoodEnough(handle->getIncumbent())) {
+                if (debug > 1) context->print("Solution %.6f is good enough, stopping after %.2fs and %d nodes\n", 
+                                              handle->getIncumbent(), handle->getElapsedTime(), handle->getNodeCount());
+                handle->cancel();
+            }
+        }
+    } catch (...) {
+        delete(handle);
+        throw;
+    }
+    delete(handle);
+}
+
+/**
+ * The solver, as set up by the model, races against numSolvers - 1 copies loaded from the IR with 
+ * other MIP emphasis, MIP strategy and random seed. Threads are split among them.
+ */
+void Model::solveRace(int numSolvers) {
+    Options* options = context->getOptions();
+    int baseEmphasis = options->getIntOption("mip_emphasis");
+    int baseStrategy = options->getIntOption("mip_strategy");
+    int baseSeed     = options->getIntOption("solver_random_seed");
+    int parallelism  = options->getIntOption("solver_parallelism");
+    int threads      = options->getIntOption("solver_threads");
+    if (threads == 0) threads = (int)std::thread::hardware_concurrency();
+    threads = std::max(1, threads / numSolvers);
+
+    vector<Solver*> solvers(1, solver);
+    for (int k = 1; k < numSolvers; k++) {
+        Solver* s = createSolver();
+        s->loadModel(ir);
+        s->changeObjectiveSense(isMax);
+        applySolverParameters(s);
+        addCallbacks(s);
+        solvers.push_back(s);
+    }
+
+    SolverRace race(isMax, RACE_GAP);
+    vector<int> emphasis(numSolvers), strategy(numSolvers), seed(numSolvers);
+    for (int k = 0; k < numSolvers; k++) {
+        // 0 is the configuration given by the options, then emphasis 1 to 4 in turns
+        emphasis[k] = k == 0 ? baseEmphasis : 1 + (k - 1) % 4;
+        strategy[k] = (baseStrategy + k) % 3;
+        seed[k]     = k == 0 ? baseSeed : baseSeed + k;
+
+        solvers[k]->setMIPEmphasis(emphasis[k]);
+        solvers[k]->setMIPStrategy(strategy[k]);
+        solvers[k]->setSolverRandomSeed(seed[k]);
+        solvers[k]->setSolverParallelism(threads, parallelism);
+        race.add(solvers[k], "mip_emphasis = " + lex(emphasis[k]) + ", mip_strategy = " + lex(strategy[k]) + 
+                             ", solver_random_seed = " + lex(seed[k]));
+    }
+    race.solve();
+
+    int winner = race.getHolder() != -1 ? race.getHolder() : race.getProver() != -1 ? race.getProver() : 0;
+    raceProved  = race.isProved() && race.getHolder() != -1;
+    raceBounded = race.hasBestBound();
+    raceBound   = race.getBestBound();
+
+    if (debug) {
+        context->print("Race of %d configurations (%d threads each): configuration %d won (%s)", 
+                       numSolvers, threads, winner, race.getDescription(winner).c_str());
+        if (race.getHolder() != -1) context->print(", best solution %.6f", race.getBestValue());
+        if (race.getProver() != -1) context->print(", closed by configuration %d", race.getProver());
+        context->print("\n");
+    }
+    context->setCounter("race_winner", winner);
+
+    solver = solvers[winner];
+    for (int k = 0; k < numSolvers; k++) if (k != winner) delete(solvers[k]);
+    if (winner != 0) recorder = NULL;
+}
+
+void Model::replayTrace(const string& filename) {
+    double startTime = Util::getWallTime();
+    RecordingSolver::replay(filename, solver, debug);
+    solvingTime = Util::getWallTime() - startTime;
+
+    context->print("Trace %s replayed in %.2fs, status = %d", filename.c_str(), solvingTime, solver->getStatus());
+    if (solver->solutionExists()) context->print(", objective = %.6f", solver->getObjValue());
+    context->print("\n");
+}
+
 void Model::setTimeLimit(double time) {
     timeLimit = time;
 }
@@ -99,48 +299,18 @@ void Model::setCaptureCuts(int c) {
 }
 
 void Model::setSolverParameters(int isMaximisation, string modelFilename, string solverModelFile) {
+    if (modelFilename.empty()) modelFilename = context->getOptions()->getStringOption("lp_filename");
 
     isMax = isMaximisation;
     solver->changeObjectiveSense(isMax);
 
     solverModelFilename = solverModelFile;        
-    solver->debugInformation(debug);
-    if (debug) solver->debugLevel(Options::getInstance()->getIntOption("solver_debug_level"));
-    
-    solver->enablePresolve(Options::getInstance()->getBoolOption("presolve"));
-    solver->setMIPEmphasis(Options::getInstance()->getIntOption("mip_emphasis"));
-    solver->setMIPStrategy(Options::getInstance()->getIntOption("mip_strategy"));
-    solver->setSolverParallelism(Options::getInstance()->getIntOption("solver_threads"), Options::getInstance()->getIntOption("solver_parallelism"));
-    solver->setNodeHeuristic(Options::getInstance()->getIntOption("node_heuristic"));
-    solver->setSolverLocalBranching(Options::getInstance()->getBoolOption("solver_local_branching"));
-    solver->setProbingLevel(Options::getInstance()->getIntOption("probing_level"));
-    solver->setTimeLimit(timeLimit);
-    
-    int cuts      = Options::getInstance()->getIntOption("solver_cuts"   );
-    int clique    = Options::getInstance()->getIntOption("clique_cuts"   );
-    int cover     = Options::getInstance()->getIntOption("cover_cuts"    );
-    int disj      = Options::getInstance()->getIntOption("disj_cuts"     );
-    int landp     = Options::getInstance()->getIntOption("landp_cuts"    );
-    int flowcover = Options::getInstance()->getIntOption("flowcover_cuts");
-    int flowpath  = Options::getInstance()->getIntOption("flowpath_cuts" );
-    int gomory    = Options::getInstance()->getIntOption("gomory_cuts"   );
-    int gub       = Options::getInstance()->getIntOption("gub_cuts"      );
-    int implbd    = Options::getInstance()->getIntOption("implbd_cuts"   );
-    int mir       = Options::getInstance()->getIntOption("mir_cuts"      );
-    int mcf       = Options::getInstance()->getIntOption("mcf_cuts"      );
-    int zerohalf  = Options::getInstance()->getIntOption("zerohalf_cuts" );
-    solver->setSolverCuts(cuts, clique, cover, disj, landp, flowcover, flowpath,
-                          gomory, gub, implbd, mir, mcf, zerohalf);
-
-    solver->setLPMethod(Options::getInstance()->getIntOption("lp_method"));
-    solver->setFeasibilityPump(Options::getInstance()->getIntOption("feasibility_pump"));
-    solver->setSolverRandomSeed(Options::getInstance()->getIntOption("solver_random_seed"));
+    applySolverParameters(solver);
 
     if (!captureCuts) {
-        if (Options::getInstance()->getBoolOption("first_node_only")) solver->setNodeLimit(1);
-        if ( Options::getInstance()->getBoolOption("export_model"))      solver->exportModel(modelFilename.c_str());
+        if (context->getOptions()->getBoolOption("export_model")) solver->exportModel(modelFilename.c_str());
     
-        maxExportedSolverModels = Options::getInstance()->getIntOption("export_cplex_cuts");
+        maxExportedSolverModels = context->getOptions()->getIntOption("export_cplex_cuts");
         if (maxExportedSolverModels) solver->addSolveCallback(this);
     } else {
         solver->setNodeLimit(1);
@@ -151,6 +321,69 @@ void Model::setSolverParameters(int isMaximisation, string modelFilename, string
     }
 }
 
+void Model::applySolverParameters(Solver* s) {
+    s->debugInformation(debug);
+    if (debug) s->debugLevel(context->getOptions()->getIntOption("solver_debug_level"));
+    
+    s->enablePresolve(context->getOptions()->getBoolOption("presolve"));
+    s->setMIPEmphasis(context->getOptions()->getIntOption("mip_emphasis"));
+    s->setMIPStrategy(context->getOptions()->getIntOption("mip_strategy"));
+    s->setSolverParallelism(context->getOptions()->getIntOption("solver_threads"), context->getOptions()->getIntOption("solver_parallelism"));
+    s->setNodeHeuristic(context->getOptions()->getIntOption("node_heuristic"));
+    s->setSolverLocalBranching(context->getOptions()->getBoolOption("solver_local_branching"));
+    s->setProbingLevel(context->getOptions()->getIntOption("probing_level"));
+    s->setTimeLimit(timeLimit);
+    
+    int cuts      = context->getOptions()->getIntOption("solver_cuts"   );
+    int clique    = context->getOptions()->getIntOption("clique_cuts"   );
+    int cover     = context->getOptions()->getIntOption("cover_cuts"    );
+    int disj      = context->getOptions()->getIntOption("disj_cuts"     );
+    int landp     = context->getOptions()->getIntOption("landp_cuts"    );
+    int flowcover = context->getOptions()->getIntOption("flowcover_cuts");
+    int flowpath  = context->getOptions()->getIntOption("flowpath_cuts" );
+    int gomory    = context->getOptions()->getIntOption("gomory_cuts"   );
+    int gub       = context->getOptions()->getIntOption("gub_cuts"      );
+    int implbd    = context->getOptions()->getIntOption("implbd_cuts"   );
+    int mir       = context->getOptions()->getIntOption("mir_cuts"      );
+    int mcf       = context->getOptions()->getIntOption("mcf_cuts"      );
+    int zerohalf  = context->getOptions()->getIntOption("zerohalf_cuts" );
+    s->setSolverCuts(cuts, clique, cover, disj, landp, flowcover, flowpath,
+                     gomory, gub, implbd, mir, mcf, zerohalf);
+    s->setCutSelection(context->getOptions()->getIntOption("cut_budget"), context->getOptions()->getDoubleOption("cut_max_parallelism"));
+
+    s->setLPMethod(context->getOptions()->getIntOption("lp_method"));
+    s->setFeasibilityPump(context->getOptions()->getIntOption("feasibility_pump"));
+    s->setSolverRandomSeed(context->getOptions()->getIntOption("solver_random_seed"));
+    if (!captureCuts && context->getOptions()->getBoolOption("first_node_only")) s->setNodeLimit(1);
+}
+
+void Model::addInfoCallback() {
+    callbacks |= INFO_CALLBACK;
+    solver->addInfoCallback(this);
+}
+
+void Model::addLazyCallback() {
+    callbacks |= LAZY_CALLBACK;
+    solver->addLazyCallback(this);
+}
+
+void Model::addUserCutCallback() {
+    callbacks |= USER_CUT_CALLBACK;
+    solver->addUserCutCallback(this);
+}
+
+void Model::addIncumbentCallback() {
+    callbacks |= INCUMBENT_CALLBACK;
+    solver->addIncumbentCallback(this);
+}
+
+void Model::addCallbacks(Solver* s) {
+    if (callbacks & INFO_CALLBACK)      s->addInfoCallback(this);
+    if (callbacks & LAZY_CALLBACK)      s->addLazyCallback(this);
+    if (callbacks & USER_CUT_CALLBACK)  s->addUserCutCallback(this);
+    if (callbacks & INCUMBENT_CALLBACK) s->addIncumbentCallback(this);
+}
+
 int Model::shouldExportMoreSolverModels() {
     if (numExportedSolverModels < maxExportedSolverModels) return 1;
     return 0;
@@ -171,18 +404,110 @@ int Model::isSolutionGoodEnough(double value) {
 }
 
 
-void Model::bestSolutionValueCallbackFunction(double value) {
-    if (bestSolutionSoFar == -10000000 || value > bestSolutionSoFar + TOLERANCE || value < bestSolutionSoFar - TOLERANCE) {
-        bestSolutionSoFar = value;
-        bestSolutionTime = Util::getWallTime() - solverStartTime;
+/**
+ * CALLBACKS
+ *
+ */
+
+/**
+ * Cuts still in the pool are tried first, the separation only runs if none of them is violated.
+ * Separated cuts the pool already had are dropped, unless sol violates them: the pool may have
+ * got them from another thread since it was checked.
+ */
+void Model::separate(Span<double> sol, CutBuffer& cuts) {
+    CallbackStats& stats = threadStats();
+    double startTime = Util::getWallTime();
+    int numCuts = cuts.getNumCuts();
+
+    int pooled = cutPool.isEnabled() ? cutPool.check(sol.data(), TOLERANCE, cuts) : 0;
+    if (pooled == 0) {
+        if (parallelCallbacks) {
+            separationAlgorithm(sol, cuts);
+        } else {
+            std::lock_guard<std::mutex> guard(callbackMutex);
+            separationAlgorithm(sol, cuts);
+        }
+        if (cutPool.isEnabled()) stats.duplicateCuts += cutPool.add(cuts, numCuts, sol.data(), TOLERANCE);
+        if (recorder) recorder->recordCuts(cuts, numCuts);
+    }
+
+    stats.callbackCalls++;
+    stats.poolCuts     += pooled;
+    stats.cutsAdded    += cuts.getNumCuts() - numCuts;
+    stats.callbackTime += Util::getWallTime() - startTime;
+}
+
+void Model::incumbentFound(const double& objval, const double* sol) {
+    if (parallelCallbacks) {
+        incumbentCallbackFunction(objval, sol);
+    } else {
+        std::lock_guard<std::mutex> guard(callbackMutex);
+        incumbentCallbackFunction(objval, sol);
     }
 }
 
+// Several threads (or solvers of a race) may report values at the same time, only improvements are recorded
+void Model::bestSolutionValueCallbackFunction(double value) {
+    double current = bestSolutionSoFar;
+    do {
+        if (isMax ? value <= current + TOLERANCE : value >= current - TOLERANCE) return;
+    } while (!bestSolutionSoFar.compare_exchange_weak(current, value));
+    bestSolutionTime = Util::getWallTime() - solverStartTime;
+}
+
 void Model::firstNodeBoundCallbackFunction(double bound) {
-    if (firstNodeSolved) return;
-    firstNodeTime = Util::getWallTime() - solverStartTime;
+    if (firstNodeSolved.exchange(true)) return;
+    firstNodeTime  = Util::getWallTime() - solverStartTime;
     firstNodeBound = bound;
-    firstNodeSolved = true;
+}
+
+/**
+ * The slot of the calling thread. Each thread looks it up once (per model), under a lock, and caches it
+ * so that later calls share nothing with other threads.
+ */
+CallbackStats& Model::threadStats() {
+    thread_local unsigned long  owner = 0;
+    thread_local CallbackStats* stats = NULL;
+    if (owner == id) return *stats;
+
+    std::lock_guard<std::mutex> guard(callbackStatsMutex);
+    stats = new CallbackStats();
+    owner = id;
+    callbackStats.push_back(stats);
+    return *stats;
+}
+
+// Only called when no callback is running
+void Model::mergeCallbackStats() {
+    std::lock_guard<std::mutex> guard(callbackStatsMutex);
+    for (CallbackStats* stats : callbackStats) {
+        callbackTime     += stats->callbackTime;
+        callbackDataTime += stats->callbackDataTime;
+        callbackCutsTime += stats->callbackCutsTime;
+        maxFlowTime      += stats->maxFlowTime;
+        bfsTime          += stats->bfsTime;
+        maxFlowCalls     += stats->maxFlowCalls;
+        maxFlowsSolved   += stats->maxFlowsSolved;
+        callbackCalls    += stats->callbackCalls;
+        cutsAdded        += stats->cutsAdded;
+        poolCuts         += stats->poolCuts;
+        duplicateCuts    += stats->duplicateCuts;
+        stats->clear();
+    }
+}
+
+void CallbackStats::clear() {
+    callbackTime     = 0;
+    callbackDataTime = 0;
+    callbackCutsTime = 0;
+    maxFlowTime      = 0;
+    bfsTime          = 0;
+    maxFlowCalls     = 0;
+    maxFlowsSolved   = 0;
+    callbackCalls    = 0;
+    cutsAdded        = 0;
+    poolCuts         = 0;
+    duplicateCuts    = 0;
 }
 
 void Model::getExtraCuts(vector<SolverCut>& sc) {
@@ -13,6 +13,35 @@
 #include "Data.h"
 #include "Solution.h"
 #include "Options.h"
+#include "RunContext.h"
+#include "CutBuffer.h"
+#include "CutPool.h"
+#include "Span.h"
+#include <atomic>
+#include <mutex>
+
+// Statistics gathered by the callbacks of one thread
+struct CallbackStats {
+    // Slots are written by different threads, the padding keeps each one on cache lines of its own
+    char   paddingBefore[CACHE_LINE_SIZE];
+    double callbackTime;
+    double callbackDataTime;
+    double callbackCutsTime;
+    double maxFlowTime;
+    double bfsTime;
+    int    maxFlowCalls;
+    int    maxFlowsSolved;
+    int    callbackCalls;
+    int    cutsAdded;
+    int    poolCuts;
+    int    duplicateCuts;
+    char   paddingAfter[CACHE_LINE_SIZE];
+
+    CallbackStats() { clear(); }
+    void clear();
+};
+
+class RecordingSolver;
 
 /**
  * Model, superclass of ssd, etc.
@@ -21,7 +50,10 @@ class Model {
 
     protected:
         
+       RunContext* context;
        Solver* solver;
+       // Set when calls are traced, gets the cuts found by the callbacks
+       RecordingSolver* recorder;
        Solution* solution;
       
        vector<string> warmStartNames;
@@ -56,13 +88,16 @@ class Model {
        int maxFlowsSolved;
        int callbackCalls;
        int cutsAdded;
-
-       // Inner optimisation data
-       double bestSolutionTime;
-       double firstNodeTime;
-       double firstNodeBound;
-       bool   firstNodeSolved;
-       double bestSolutionSoFar;
+       // Cuts taken from the pool, and separated cuts dropped because the pool had them
+       int poolCuts;
+       int duplicateCuts;
+
+       // Inner optimisation data, set from callbacks
+       std::atomic<double> bestSolutionTime;
+       std::atomic<double> firstNodeTime;
+       std::atomic<double> firstNodeBound;
+       std::atomic<bool>   firstNodeSolved;
+       std::atomic<double> bestSolutionSoFar;
  
        // Nodes
        int totalNodes;
@@ -80,30 +115,75 @@ class Model {
        int maxExportedSolverModels;
        int numExportedSolverModels;
 
-       void setSolverParameters(int isMaximisation, string modelFilename = Options::getInstance()->getStringOption("lp_filename"), string solverModelFile = "cplexModel");
+       void setSolverParameters(int isMaximisation, string modelFilename = "", string solverModelFile = "cplexModel");
+       // Parameters given by the options, except those for exporting models
+       void applySolverParameters(Solver* s);
+       // Solver chosen in the options
+       Solver* createSolver();
+
+       // Callbacks are recorded, so that they can also be added to the solvers of a race
+       int callbacks;
+       void addInfoCallback();
+       void addLazyCallback();
+       void addUserCutCallback();
+       void addIncumbentCallback();
+       void addCallbacks(Solver* s);
+
+       // Callbacks may be called from several threads (and solvers). Unless parallelCallbacks is set
+       // separationAlgorithm and incumbentCallbackFunction are called one at a time
+       std::mutex callbackMutex;
+       bool parallelCallbacks;
+
+       // Statistics of the callbacks, one slot per thread, added to the totals above once the solve is over
+       unsigned long id;
+       vector<CallbackStats*> callbackStats;
+       std::mutex callbackStatsMutex;
+       CallbackStats& threadStats();
+       void mergeCallbackStats();
+
+       // Cuts of separationAlgorithm, checked before it is called again (see CutPool)
+       CutPool cutPool;
+
+       // Races numSolvers configurations (see SolverRace), the solver is replaced by the one holding the best solution
+       void solveRace(int numSolvers);
+       // Solves asynchronously, stopping as soon as the incumbent is good enough
+       void solveUntilGoodEnough();
+       bool   raceProved;
+       bool   raceBounded;
+       double raceBound;
       
        virtual void reserveSolutionSpace(const Data* data) {}
        virtual void readSolution        (const Data* data) {}
        virtual void assignWarmStart     (const Data* data) {}
+       // Model as built by createModel, kept so that it can be inspected or loaded into other solvers
+       ModelIR ir;
+
        virtual void createModel         (const Data* data) {}
+       void buildModel                  (const Data* data);
        virtual void solve               (const Data* data);
 
     public:
         
         // Create and destroy
-        Model();
+        Model(RunContext* ctx = NULL);
         virtual ~Model();
 
         virtual void execute(const Data* data) {}
+        // Calls the solver as recorded in a trace file (see RecordingSolver)
+        void replayTrace(const string& filename);
 
         Solution* getSolution()  { return solution;  }
+        const ModelIR& getModelIR() { return ir;    }
         void printSolution()     { solution->print(); }
 
 
-        virtual vector<SolverCut> separationAlgorithm(vector<double> sol) {
-            vector<SolverCut> sc;
-            return sc;
-        }
+        // Called by solvers, from any thread, rather than the callback functions themselves.
+        // separate adds the cuts found for sol to cuts
+        void separate(Span<double> sol, CutBuffer& cuts);
+        void incumbentFound(const double& objval, const double* sol);
+
+        // sol is only valid during the call, cuts are added to the given buffer (which may already hold some)
+        virtual void separationAlgorithm(Span<double> sol, CutBuffer& cuts) {}
         virtual void incumbentCallbackFunction(const double& objval, const double* sol) {}
         virtual void bestSolutionValueCallbackFunction(double value);
         virtual void firstNodeBoundCallbackFunction(double bound);
@@ -112,6 +192,7 @@ class Model {
         string getSolverModelFilename () {return solverModelFilename;}
 
         Solver* getSolver           () {return solver;             }
+        std::mutex& getCallbackMutex() {return callbackMutex;      }
         double getTotalTime         () {return totalTime;          }
         double getSolvingTime       () {return solvingTime;        }
  
@@ -126,6 +207,8 @@ class Model {
         int getMaxFlowsSolved       () {return maxFlowsSolved;     }
         int getCallbackCalls        () {return callbackCalls;      }
         int getCutsAdded            () {return cutsAdded;          }
+        int getPoolCuts             () {return poolCuts;           }
+        int getDuplicateCuts        () {return duplicateCuts;      }
  
         double getBestSolutionTime  () {return bestSolutionTime;   }
         double getFirstNodeTime     () {return firstNodeTime;      }
@@ -3,7 +3,7 @@
 #include "Options.h"
 #include "DataAssignmentProblem.h"
 
-ModelAssignmentProblem::ModelAssignmentProblem() : Model(){
+ModelAssignmentProblem::ModelAssignmentProblem(RunContext* ctx) : Model(ctx){
     V = 0;
     x = "x";
 }
@@ -17,12 +17,12 @@ void ModelAssignmentProblem::execute(const Data* data) {
     float startTime = Util::getTime();
     
     if (debug > 1) solver->printSolverName();
-    createModel(data);
+    buildModel(data);
     reserveSolutionSpace(data);
     assignWarmStart(data);
     setSolverParameters(0);
 
-    solver->addInfoCallback(this);
+    addInfoCallback();
 
     solve(data);
     totalTime = Util::getTime() - startTime;
@@ -32,17 +32,17 @@ void ModelAssignmentProblem::execute(const Data* data) {
 
 void ModelAssignmentProblem::printSolutionVariables(int digits, int decimals) {
     if (debug) {
-        printf("\nSolution: \n");
+        context->print("\nSolution: \n");
         for (int i = 0; i < V; i++) {
-            printf("\t Xi%d", i);
+            context->print("\t Xi%d", i);
         }
-        printf("\n");
+        context->print("\n");
         for (int i = 0; i < V; i++) {
-            printf("X%dj", i);
+            context->print("X%dj", i);
             for (int j = 0; j < V; j++) {
-                printf("\t %.0f", sol_x[i][j]);
+                context->print("\t %.0f", sol_x[i][j]);
             }
-            printf("\n");
+            context->print("\n");
         }
     }
 
@@ -57,14 +57,15 @@ void ModelAssignmentProblem::readSolution(const Data* data) {
     solution->resetSolution();
     solution->setSolutionStatus(solver->solutionExists(), solver->isOptimal(),  solver->isInfeasible(), solver->isUnbounded());
     if (!solver->solutionExists()) {
-        if (debug) printf("Solution does not exist\n");        
+        if (debug) context->print("Solution does not exist\n");        
     } else {
         solution->setValue    (solver->getObjValue() );
         solution->setBestBound(solver->getBestBound());
 
+        const double* sol = solver->getColValues();
         for (int i = 0; i < V; i++) {
             for (int j = 0; j < V; j++) {
-                sol_x[i][j] = solver->getColValue(x + lex(i) + lex(j));
+                sol_x[i][j] = xVar.value(sol, i, j);
             }
         }
     }
@@ -76,33 +77,21 @@ void ModelAssignmentProblem::createModel(const Data* data) {
     V = dataAP->getNumVariables();
     solver->changeObjectiveSense(0);
 
-    for (int i = 0; i < V; i++) {
-        for (int j = 0; j < V; j++) {
-            solver->addBinaryVariable(dataAP->getCost(i, j), x + lex(i) + lex(j));
-        }
-    }
+    xVar.create(solver, 'B', 0, 1, x, {{V, V}}, [dataAP](const VarFamily<2>::Tuple& t) { return dataAP->getCost(t[0], t[1]); });
 
-    vector<vector<string>> colNames;
-    vector<vector<double>> elements;
-
-    colNames.resize(V, vector<string>(V));
-    elements.resize(V, vector<double>(V));
+    vector<int>    colIndices(V);
+    vector<double> elements(V, 1);
 
     // first constraint 
     for (int i = 0; i < V; i++) {
-        for (int j = 0; j < V; j++) {
-            colNames[i][j] = x + lex(i) + lex(j);
-            elements[i][j] = 1;
-        }
-        solver->addRow(colNames[i], elements[i], 1, 'E', "constraint");
+        for (int j = 0; j < V; j++) colIndices[j] = xVar.col(i, j);
+        solver->addRow(V, &colIndices[0], &elements[0], 1, 'E', "constraint");
     }
 
-    vector<vector<string>> transposedColNames = Util::transposeStringMatrix(colNames, V, V);
-    vector<vector<double>> transposedElements = Util::transposeDoubleMatrix(elements, V, V);
-
     // second constraint 
     for (int j = 0; j < V; j++) {
-        solver->addRow(transposedColNames[j], transposedElements[j], 1, 'E', "constraint");
+        for (int i = 0; i < V; i++) colIndices[i] = xVar.col(i, j);
+        solver->addRow(V, &colIndices[0], &elements[0], 1, 'E', "constraint");
     }
 }
 
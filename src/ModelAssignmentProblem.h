@@ -5,6 +5,7 @@
 #include "Model.h"
 #include "Solution.h"
 #include "Util.h"
+#include "VarFamily.h"
 
 class ModelAssignmentProblem : public Model {
 
@@ -12,6 +13,7 @@ class ModelAssignmentProblem : public Model {
     
         // Variable names
         string x;
+        VarFamily<2> xVar;
         
         // Solution values
         int V;
@@ -26,7 +28,7 @@ class ModelAssignmentProblem : public Model {
         
     public:
         
-        ModelAssignmentProblem();
+        ModelAssignmentProblem(RunContext* ctx = NULL);
 
         virtual ~ModelAssignmentProblem();
 
@@ -16,7 +16,7 @@
 
 // If dataModelCapitalBudgeting was a reference
 //ModelCapitalBudgeting::ModelCapitalBudgeting(DataModelCapitalBudgeting& i) : Model(), dataModelCapitalBudgeting(i) {
-ModelCapitalBudgeting::ModelCapitalBudgeting() : Model(){
+ModelCapitalBudgeting::ModelCapitalBudgeting(RunContext* ctx) : Model(ctx){
     V = 0;
     x = "x";
 }
@@ -30,14 +30,14 @@ void ModelCapitalBudgeting::execute(const Data* data) {
     float startTime = Util::getTime();
     
     if (debug > 1) solver->printSolverName();
-    createModel(data);
+    buildModel(data);
     reserveSolutionSpace(data);
     assignWarmStart(data);
     setSolverParameters(1);
 
-    solver->addInfoCallback(this);
-    //solver->addLazyCallback(this);
-    //solver->addUserCutCallback(this);
+    addInfoCallback();
+    //addLazyCallback();
+    //addUserCutCallback();
 
     solve(data);
     totalTime = Util::getTime() - startTime;
@@ -47,9 +47,9 @@ void ModelCapitalBudgeting::execute(const Data* data) {
 
 void ModelCapitalBudgeting::printSolutionVariables(int digits, int decimals) {
     if (debug) {
-        printf("\nSolution: \n");
+        context->print("\nSolution: \n");
         for (int i = 0; i < V; i++) {
-            printf("  x%d = %.0f\n", i, sol_x[i]);
+            context->print("  x%d = %.0f\n", i, sol_x[i]);
     
         }
     }
@@ -70,7 +70,7 @@ void ModelCapitalBudgeting::readSolution(const Data* data) {
     solution->resetSolution();
     solution->setSolutionStatus(solver->solutionExists(), solver->isOptimal(),  solver->isInfeasible(), solver->isUnbounded());
     if (!solver->solutionExists()) {
-        if (debug) printf("Solution does not exist\n");        
+        if (debug) context->print("Solution does not exist\n");        
     } else {
         solution->setValue    (solver->getObjValue() );
         solution->setBestBound(solver->getBestBound());
@@ -155,12 +155,10 @@ void ModelCapitalBudgeting::assignWarmStart(const Data* data) {
 // Cutting plane
 
 /*
-vector<SolverCut> ModelCapitalBudgeting::separationAlgorithm(vector<double> sol) {
+void ModelCapitalBudgeting::separationAlgorithm(Span<double> sol, CutBuffer& cuts) {
 
     
 
-    vector<SolverCut> cuts;
-
     // Finding out whether the current solution is integer or not
     int isInteger = 1;
     for (unsigned i = 0; i < sol.size(); i++) {
@@ -179,14 +177,8 @@ vector<SolverCut> ModelCapitalBudgeting::separationAlgorithm(vector<double> sol)
     //double ysol = sol[solver->getColIndex(y + lex(t) + "_" + lex(b))];
       
     // Creating and adding a cut y_{tb} >= -1 as an example
-    //SolverCut cut;
-    //cut.setSense('G');
-    //cut.addCoef(solver->getColIndex(y + lex(t) + "_" + lex(b)), 1);
-    //cut.setRHS(-1);
-    //cuts.push_back(cut);
-
-
+    //cuts.addCoef(solver->getColIndex(y + lex(t) + "_" + lex(b)), 1);
+    //cuts.addCut('G', -1);
 
-    return cuts;
 }
 */
@@ -35,7 +35,7 @@ class ModelCapitalBudgeting : public Model {
         
     public:
         
-        ModelCapitalBudgeting();
+        ModelCapitalBudgeting(RunContext* ctx = NULL);
 
         virtual ~ModelCapitalBudgeting();
 
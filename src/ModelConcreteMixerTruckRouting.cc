@@ -3,15 +3,26 @@
 #include "Options.h"
 #include "DataConcreteMixerTruckRouting.h"
 
-ModelConcreteMixerTruckRouting::ModelConcreteMixerTruckRouting() : Model(){
+// Trucks are separated in parallel only from this many columns of x, unless separation_threads says otherwise
+#define CMTR_PARALLEL_SEPARATION_COLUMNS 20000
+
+ModelConcreteMixerTruckRouting::ModelConcreteMixerTruckRouting(RunContext* ctx) : Model(ctx){
     V = 0;
     K = 0;
     x = "x";
     y = "y";
     z = "z";
+    separationPool = NULL;
+    parallelSeparationForced = false;
+    aggregatedCuts = false;
+    truckCapacity = 0;
+
+    // The separation only uses local data, solver threads may run it at the same time
+    parallelCallbacks = true;
 }
 
 ModelConcreteMixerTruckRouting::~ModelConcreteMixerTruckRouting() {
+    delete(separationPool);
 }
 
 void ModelConcreteMixerTruckRouting::execute(const Data* data) {
@@ -20,13 +31,18 @@ void ModelConcreteMixerTruckRouting::execute(const Data* data) {
 
     if (debug > 1) solver->printSolverName();
 
-    createModel(data);
+    buildModel(data);
+    int separationThreads = context->getOptions()->getIntOption("separation_threads");
+    if (separationThreads != 1 && K > 1) separationPool = new ThreadPool(separationThreads);
+    parallelSeparationForced = separationThreads > 1;
+    aggregatedCuts = context->getOptions()->getBoolOption("aggregated_connectivity_cuts");
     reserveSolutionSpace(data);
     assignWarmStart(data);
     setSolverParameters(0);
 
-    solver->addInfoCallback(this);
-    solver->addLazyCallback(this);
+    addInfoCallback();
+    addLazyCallback();
+    addUserCutCallback();
 
     solve(data);
 
@@ -38,51 +54,48 @@ void ModelConcreteMixerTruckRouting::printSolutionVariables(int digits, int deci
     if (debug) {
         if (solver->solutionExists() && !solver->isInfeasible() && !solver->isUnbounded()) {
             vector<string> route;
-            int indexRoute;
-            printf("\nSolution: \n");
+            context->print("\nSolution: \n");
             for (int k = 0; k < K; k++) {
-                route.resize(V);
-                std::fill(route.begin(), route.end(), "");
-                indexRoute = 0;
-                printf("Concrete Mixer Truck %d \n", k);
+                route.clear();
+                context->print("Concrete Mixer Truck %d \n", k);
                 for (int j = 0; j < V; j++) {
-                    printf("\t Xi%d", j);
+                    context->print("\t Xi%d", j);
                 }
-                printf("\n");
+                context->print("\n");
                 for (int i = 0; i < V; i++) {
-                    printf("X%dj", i);
+                    context->print("X%dj", i);
                     for (int j = 0; j < V; j++) {
                         if(i == j || round(sol_x[k][i][j]) == -0)
-                            printf("\t 0");
+                            context->print("\t 0");
                         else
-                            printf("\t %.0f", round(sol_x[k][i][j]));
+                            context->print("\t %.0f", round(sol_x[k][i][j]));
 
                         if(round(sol_x[k][i][j]) == 1) {
-                            route[indexRoute] = "(" + lex(i) + ", " + lex(j) + ") "; 
-                            indexRoute++;
+                            // Solutions that are not optimal may use more than V arcs
+                            route.push_back("(" + lex(i) + ", " + lex(j) + ") ");
                         }
 
                     }
-                    printf("\n");
+                    context->print("\n");
                 }
-                printf("\n");
-                printf("Route (Concrete Mixer Truck %d): ", k);
-                for (int i = 0; i < V; i++) {
-                    printf("%s", route[i].c_str());
+                context->print("\n");
+                context->print("Route (Concrete Mixer Truck %d): ", k);
+                for (unsigned i = 0; i < route.size(); i++) {
+                    context->print("%s", route[i].c_str());
                 }
-                printf("\n\n");
+                context->print("\n\n");
             }
-            printf("\n");
+            context->print("\n");
             for (int k = 0; k < K; k++) {
                 if (round(sol_y[k]) == -0)
-                    printf("y%d: 0\n", k);
+                    context->print("y%d: 0\n", k);
                 else
-                    printf("y%d: %.0f\n", k, round(sol_y[k]));
+                    context->print("y%d: %.0f\n", k, round(sol_y[k]));
             }
-            printf("\n");
+            context->print("\n");
             for (int k = 0; k < K; k++) {
                 for (int j = 1; j < V; j++) {
-                    printf("z%d%d: %f\n", k, j, sol_z[k][j]);
+                    context->print("z%d%d: %f\n", k, j, sol_z[k][j]);
                 }
             }
         }
@@ -101,29 +114,28 @@ void ModelConcreteMixerTruckRouting::readSolution(const Data* data) {
     solution->resetSolution();
     solution->setSolutionStatus(solver->solutionExists(), solver->isOptimal(),  solver->isInfeasible(), solver->isUnbounded());
     if (!solver->solutionExists()) {
-        if (debug) printf("Solution does not exist\n");        
+        if (debug) context->print("Solution does not exist\n");        
     } else {
         solution->setValue    (solver->getObjValue() );
         solution->setBestBound(solver->getBestBound());
 
+        const double* sol = solver->getColValues();
+
         for (int k = 0; k < K; k++) {
             for (int i = 0; i < V; i++) {
                 for (int j = 0; j < V; j++) {
-                    if (i == j)
-                        sol_x[k][i][j] = 0;
-                    else
-                        sol_x[k][i][j] = solver->getColValue(x + lex(k) + UND + lex(i) + UND + lex(j));
+                    sol_x[k][i][j] = xVar.value(sol, k, i, j);
                 }
             }
         }
 
         for (int k = 0; k < K; k++) {
-            sol_y[k] = solver->getColValue(y + lex(k));
+            sol_y[k] = yVar.value(sol, k);
         }
 
         for (int k = 0; k < K; k++) {
             for (int j = 1; j < V; j++) {
-                sol_z[k][j] = solver->getColValue(z + lex(k) + UND  + lex(j));
+                sol_z[k][j] = zVar.value(sol, k, j);
             }
         }
     }
@@ -135,419 +147,523 @@ void ModelConcreteMixerTruckRouting::createModel(const Data* data) {
     const DataConcreteMixerTruckRouting* dataCMR = dynamic_cast<const DataConcreteMixerTruckRouting*>(data);
     V = (dataCMR->getNumberOfConstructions()) + 1;
     K = dataCMR->getConcreteMixerTruckFleet();
+    truckCapacity = dataCMR->getConcreteMixerTruckCapacity();
+    arcs = dataCMR->getAdmissibleArcs();
+    demand.assign(V, 0);
+    for (int j = 1; j < V; j++) demand[j] = dataCMR->getDemand(j).getQuantity(dataCMR->getDemand(j).constructionId);
     solver->changeObjectiveSense(0);
 
+    // Names are given to each block of constraints after it is created, so that
+    // they are only generated if needed (see option solver_names)
+    int nV = V;
+
     // x variable
-    for (int k = 0; k < K; k++) {
-        for (int i = 0; i < V; i++) {
-            for (int j = 0; j < V; j++) {
-                if (i != j)
-                    solver->addBinaryVariable(dataCMR->getDistance(i, j), x + lex(k) + UND + lex(i) + UND + lex(j));
-            }
-        }
-    }
+    xVar.create(solver, 'B', 0, 1, x, {{K, V, V}}, 
+                [dataCMR](const VarFamily<3>::Tuple& t) { return dataCMR->getDistance(t[1], t[2]); },
+                [dataCMR](const VarFamily<3>::Tuple& t) { return dataCMR->isArcAdmissible(t[1], t[2]); });
 
     // y variable
-    for (int k = 0; k < K; k++)
-        solver->addBinaryVariable(dataCMR->getFixedCost(), y + lex(k));
+    yVar.create(solver, 'B', 0, 1, y, {{K}}, [dataCMR](const VarFamily<1>::Tuple& t) { return dataCMR->getFixedCost(); });
 
     // z variable
-    for (int k = 0; k < K; k++) {
-        for (int j = 1; j < V; j++) {
-            solver->addVariable(0, 1, 1, z + lex(k) + UND + lex(j));
-        }
-    }
+    zVar.create(solver, 'C', 0, 1, z, {{K, V}}, 
+                [](const VarFamily<2>::Tuple& t) { return 1; },
+                [](const VarFamily<2>::Tuple& t) { return t[1] != 0; });
 
-    vector<string> colNames;
+    vector<int>    colIndices;
     vector<double> elements;
 
     int indexAux;
+    int firstRow;
     
     // at least one concrete mixer truck attends a client (1b and 1c)
-    colNames.resize(K * V - K);
+    firstRow = solver->getNumRows();
+    colIndices.resize(K * V - K);
     elements.resize(K * V - K);
     for (int j = 1; j < V; j++) {
         indexAux = 0;
         for (int k = 0; k < K; k++) {
             for (int i = 0; i < V; i++) {
-                if (j != i) {
-                    colNames[indexAux] = x + lex(k) + UND + lex(i) + UND + lex(j);
+                if (dataCMR->isArcAdmissible(i, j)) {
+                    colIndices[indexAux] = xVar.col(k, i, j);
                     elements[indexAux] = 1;
                     indexAux++;
                 }
             }
         }
-        solver->addRow(colNames, elements, 1, 'G', "constraint1b_" + lex(j));
+        solver->addRow(indexAux, &colIndices[0], &elements[0], 1, 'G');
     }
+    solver->setRowNames(firstRow, V - 1, [](int r) { return "constraint1b_" + lex(r + 1); });
 
-    colNames.resize(K * V - K);
+    firstRow = solver->getNumRows();
+    colIndices.resize(K * V - K);
     elements.resize(K * V - K);
     for (int i = 1; i < V; i++) {
         indexAux = 0;
         for (int k = 0; k < K; k++) {
             for (int j = 0; j < V; j++) {
-                if (i != j) {
-                    colNames[indexAux] = x + lex(k) + UND + lex(i) + UND + lex(j);
+                if (dataCMR->isArcAdmissible(i, j)) {
+                    colIndices[indexAux] = xVar.col(k, i, j);
                     elements[indexAux] = 1;
                     indexAux++;
                 }
             }
         }
-        solver->addRow(colNames, elements, 1, 'G', "constraint1c_" + lex(i));
+        solver->addRow(indexAux, &colIndices[0], &elements[0], 1, 'G');
     }
+    solver->setRowNames(firstRow, V - 1, [](int r) { return "constraint1c_" + lex(r + 1); });
 
     // relationship between x and y (1d)
-    colNames.resize(V);
+    firstRow = solver->getNumRows();
+    colIndices.resize(V);
     elements.resize(V);
     for (int k = 0; k < K; k++) {
         indexAux = 0;
 
         for (int j = 1; j < V; j++) {
-            colNames[indexAux] = x + lex(k) + UND + '0' + UND + lex(j);
+            colIndices[indexAux] = xVar.col(k, 0, j);
             elements[indexAux] = 1;
             indexAux++;
         }
 
-        colNames[indexAux] = y + lex(k);
+        colIndices[indexAux] = yVar.col(k);
         elements[indexAux] = -1;
+        indexAux++;
 
-        solver->addRow(colNames, elements, 0, 'L', "constraint1d_" + lex(k));
+        solver->addRow(indexAux, &colIndices[0], &elements[0], 0, 'L');
     }
+    solver->setRowNames(firstRow, K, [](int r) { return "constraint1d_" + lex(r); });
 
     // truck sequence (truck queue) constraint (1e)
-    colNames.resize(V + V - 2);
+    firstRow = solver->getNumRows();
+    colIndices.resize(V + V - 2);
     elements.resize(V + V - 2);
     for (int k = 1; k < K; k++) {
         indexAux = 0;
 
         for (int j = 1; j < V; j++) {
-            colNames[indexAux] = x + lex(k-1) + UND + '0' + UND + lex(j);
+            colIndices[indexAux] = xVar.col(k-1, 0, j);
             elements[indexAux] = 1;
             indexAux++;
-            colNames[indexAux] = x + lex(k) + UND + '0' + UND + lex(j);
+            colIndices[indexAux] = xVar.col(k, 0, j);
             elements[indexAux] = -1;
             indexAux++;
         }
 
-        solver->addRow(colNames, elements, 0, 'G', "constraint1e_" + lex(k));
+        solver->addRow(indexAux, &colIndices[0], &elements[0], 0, 'G');
     }
+    solver->setRowNames(firstRow, K - 1, [](int r) { return "constraint1e_" + lex(r + 1); });
 
     // enter and leave constraint (1f)
-    colNames.resize((V - 1) + (V - 1));
+    firstRow = solver->getNumRows();
+    colIndices.resize((V - 1) + (V - 1));
     elements.resize((V - 1) + (V - 1));
     for (int k = 0; k < K; k++) {
         for (int h = 0; h < V; h++) {
             indexAux = 0;
 
             for (int i = 0; i < V; i++) {
-                if (h != i) {
-                    colNames[indexAux] = x + lex(k) + UND + lex(i) + UND + lex(h);
+                if (dataCMR->isArcAdmissible(i, h)) {
+                    colIndices[indexAux] = xVar.col(k, i, h);
                     elements[indexAux] = 1;
                     indexAux++;
                 }
             }
 
             for (int j = 0; j < V; j++) {
-                if (h != j) {
-                    colNames[indexAux] = x + lex(k) + UND + lex(h) + UND + lex(j);
+                if (dataCMR->isArcAdmissible(h, j)) {
+                    colIndices[indexAux] = xVar.col(k, h, j);
                     elements[indexAux] = -1;
                     indexAux++;
                 }
             }
 
-            solver->addRow(colNames, elements, 0, 'E', "constraint1f_" + lex(k) + UND + lex(h));
+            solver->addRow(indexAux, &colIndices[0], &elements[0], 0, 'E');
         } 
     }
+    solver->setRowNames(firstRow, K * V, [nV](int r) { return "constraint1f_" + lex(r / nV) + UND + lex(r % nV); });
 
     // capacity constraint (1h)
-    colNames.resize(V - 1);
+    firstRow = solver->getNumRows();
+    colIndices.resize(V - 1);
     elements.resize(V - 1);
     for (int k = 0; k < K; k++) {
         indexAux = 0;
 
         for (int j = 1; j < V; j++) {
-            colNames[indexAux] = z + lex(k) + UND + lex(j);
+            colIndices[indexAux] = zVar.col(k, j);
             elements[indexAux] = dataCMR->getDemand(j).getQuantity(dataCMR->getDemand(j).constructionId);
             indexAux++;
         }
 
-        solver->addRow(colNames, elements, dataCMR->getConcreteMixerTruckCapacity(), 'L', "constraint1h_" + lex(k));
+        solver->addRow(indexAux, &colIndices[0], &elements[0], dataCMR->getConcreteMixerTruckCapacity(), 'L');
     }
+    solver->setRowNames(firstRow, K, [](int r) { return "constraint1h_" + lex(r); });
 
     // total percentage constraint (1i)
-    colNames.resize(K);
+    firstRow = solver->getNumRows();
+    colIndices.resize(K);
     elements.resize(K);
     for (int j = 1; j < V; j++) {
         indexAux = 0;
 
         for (int k = 0; k < K; k++) {
-            colNames[indexAux] = z + lex(k) + UND + lex(j);
+            colIndices[indexAux] = zVar.col(k, j);
             elements[indexAux] = 1;
             indexAux++;
         }
 
-        solver->addRow(colNames, elements, 1, 'E', "constraint1i_" + lex(j));
+        solver->addRow(indexAux, &colIndices[0], &elements[0], 1, 'E');
     }
+    solver->setRowNames(firstRow, V - 1, [](int r) { return "constraint1i_" + lex(r + 1); });
 
     // relationship between x and z (1j)
-    colNames.resize(V);
+    firstRow = solver->getNumRows();
+    colIndices.resize(V);
     elements.resize(V);
     for (int k = 0; k < K; k++) {
         for (int j = 1; j < V; j++) {
             indexAux = 0;
 
             for (int i = 0; i < V; i++) {
-                if (i != j) {
-                    colNames[indexAux] = x + lex(k) + UND + lex(i) + UND + lex(j);
+                if (dataCMR->isArcAdmissible(i, j)) {
+                    colIndices[indexAux] = xVar.col(k, i, j);
                     elements[indexAux] = 1;
                     indexAux++;
                 }
             }
 
-            colNames[indexAux] = z + lex(k) + UND + lex(j);
+            colIndices[indexAux] = zVar.col(k, j);
             elements[indexAux] = -1;
+            indexAux++;
 
-            solver->addRow(colNames, elements, 0, 'G', "constraint1j_" + lex(k) + UND + lex(j));
-        }
-    }
-
-    // concrete type constraint (1l) 
-    colNames.resize(1);
-    elements.resize(1);
-    for (int k = 0; k < K; k++) {
-        for (int i = 1; i < V; i++) {
-            for (int j = 1; j < V; j++) {
-                if (i != j && dataCMR->getDemand(i).getConcreteTypeId(dataCMR->getDemand(i).constructionId) != dataCMR->getDemand(j).getConcreteTypeId(dataCMR->getDemand(j).constructionId)) {
-                    colNames[0] = x + lex(k) + UND + lex(i) + UND + lex(j);
-                    elements[0] = 1;
-                    solver->addRow(colNames, elements, 0, 'E', "constraint1l_" + lex(k) + UND + lex(i) + UND + lex(j));
-                }
-            }
+            solver->addRow(indexAux, &colIndices[0], &elements[0], 0, 'G');
         }
     }
+    solver->setRowNames(firstRow, K * (V - 1), [nV](int r) { return "constraint1j_" + lex(r / (nV - 1)) + UND + lex(r % (nV - 1) + 1); });
 }
 
 void ModelConcreteMixerTruckRouting::assignWarmStart(const Data* data) { }
 
 // Cutting planes
-vector<SolverCut> ModelConcreteMixerTruckRouting::separationAlgorithm(vector<double> sol) {
-    vector<SolverCut> cuts;
-    connectivityCuts(sol, cuts);
-    return cuts;
+void ModelConcreteMixerTruckRouting::separationAlgorithm(Span<double> sol, CutBuffer& cuts) {
+    const double* xs = xVar.block(sol.data());
+    bool integer = true;
+    for (int c = 0; c < xVar.getNumCols() && integer; c++) integer = fabs(xs[c] - round(xs[c])) <= TOLERANCE;
+
+    if (aggregatedCuts) aggregatedConnectivityCuts(sol, cuts);
+    if (integer) separateTrucks(sol, cuts, &ModelConcreteMixerTruckRouting::connectivityCuts);
+    else         separateTrucks(sol, cuts, &ModelConcreteMixerTruckRouting::fractionalConnectivityCuts);
 }
 
-void ModelConcreteMixerTruckRouting::connectivityCuts(const vector<double> &sol, vector<SolverCut> &cuts) {
+/**
+ * Trucks are separated independently. Unless the model is small they are spread over the threads of
+ * separationPool, each truck into a buffer of its own, and the cuts are appended in the order of the
+ * trucks, so that they do not depend on which thread ran what.
+ */
+void ModelConcreteMixerTruckRouting::separateTrucks(Span<double> sol, CutBuffer& cuts, TruckSeparation separateTruck) {
+    if (!separationPool || (!parallelSeparationForced && xVar.getNumCols() < CMTR_PARALLEL_SEPARATION_COLUMNS)) {
+        for (int k = 0; k < K; k++) (this->*separateTruck)(sol, k, cuts);
+        return;
+    }
 
-    vector<int> newIndicesToOld; // mapeamento do grafo novo para o original (dados do grafo original)
-    vector<int> oldIndicesToNew(V); // mapeamento do grafo original para o novo (dados do grafo novo)
-    newIndicesToOld.reserve(V);
+    // Tasks run on other threads, which must see the buffers of this one
+    thread_local vector<CutBuffer> truckCutsOfThread;
+    vector<CutBuffer>& truckCuts = truckCutsOfThread;
+    if ((int)truckCuts.size() < K) truckCuts.resize(K);
+    separationPool->run(K, [this, sol, separateTruck, &truckCuts](int k) {
+        truckCuts[k].clear();
+        (this->*separateTruck)(sol, k, truckCuts[k]);
+    });
 
-    vector<vector<double>> sol_x_red; // solucões de x avaliadas
-    vector<vector<int> >   graph_red; // índices avaliados
-    sol_x_red.reserve(V);
-    graph_red.reserve(V);
-    
     for (int k = 0; k < K; k++) {
-        int addCuts = 0;
-        
-        //////////////////////////////////////////////////////////////////////////////
-        // Creating subgraph containing only visited vertices and visited edges
-        //
-        // Reduce graph to contain only those vertices and edges with values on them
-        // Map original indices to new
-        // Map new indices to original
-        // Create list of vertices in sol_y or something
-        // Create graph (edges)
-        // Create capacity graph (sol_x or something)
-        double tempTime = Util::getWallTime();
-        int currentIndex = 0;
-        sol_x_red.clear();
-        graph_red.clear();
-        newIndicesToOld.clear();
-        std::fill(oldIndicesToNew.begin(), oldIndicesToNew.end(), -1);
-
-        // criação da estrutura do novo grafo
+        for (int i = 0; i < truckCuts[k].getNumCuts(); i++) cuts.addCut(truckCuts[k], i);
+    }
+}
+
+/**
+ * Graph of the admissible arcs, arc (i, j) at its position in arcs. The graphs are kept per thread and
+ * may have been built for another model, they are only reused if they have the same arcs.
+ */
+void ModelConcreteMixerTruckRouting::buildArcGraph(MaxFlow &maxFlow) {
+    bool same = maxFlow.getNumNodes() == V && maxFlow.getNumArcs() == (int)arcs.size();
+    for (int a = 0; same && a < (int)arcs.size(); a++) same = maxFlow.getTail(a) == arcs[a].first && maxFlow.getHead(a) == arcs[a].second;
+    if (same) return;
+
+    maxFlow.reset(V);
+    for (auto& arc : arcs) maxFlow.addArc(arc.first, arc.second, 0);
+    maxFlow.build();
+}
+
+/**
+ * Connectivity cuts violated by a fractional solution. The route of a truck that uses an arc (a, h) must
+ * reach h from the depot, so every set S of clients containing h is entered at least as much as the arc
+ * is used:
+ *
+ *     sum_{i not in S, j in S} x[k][i][j] - x[k][a][h] >= 0
+ *
+ * For each client h the most violated such cut is found from a minimum cut between the depot and h, with
+ * the values of x[k] as capacities.
+ */
+void ModelConcreteMixerTruckRouting::fractionalConnectivityCuts(Span<double> sol, int k, CutBuffer &cuts) {
+    CallbackStats& stats = threadStats();
+    double startTime = Util::getWallTime();
+
+    thread_local MaxFlow maxFlow;
+    buildArcGraph(maxFlow);
+
+    thread_local vector<char> sinkSide;
+    thread_local vector<char> covered;
+    covered.assign(V, 0);
+    double total = 0;
+    for (int a = 0; a < (int)arcs.size(); a++) {
+        double value = std::max(0.0, xVar.value(sol.data(), k, arcs[a].first, arcs[a].second));
+        maxFlow.setCapacity(a, value);
+        total += value;
+    }
+    if (total <= TOLERANCE_VIOLATION) {
+        stats.maxFlowTime += Util::getWallTime() - startTime;
+        return;
+    }
+    stats.maxFlowCalls++;
+
+    for (int h = 1; h < V; h++) {
+        // Sets already cut for this truck are not cut again through another of their clients
+        if (covered[h]) continue;
+
+        int a = -1;
+        double used = TOLERANCE_VIOLATION;
         for (int i = 0; i < V; i++) {
-            for (int j = 0; j < V; j++) {
-                if (i != j) {
-                    double x_temp = sol[solver->getColIndex(x + lex(k) + UND + lex(i) + UND + lex(j))];
-                    if (round(x_temp) == 1) {
-                        newIndicesToOld.push_back(i);
-                        sol_x_red.push_back(vector<double>());
-                        graph_red.push_back(vector<int>());
-                        sol_x_red[currentIndex].reserve(V);
-                        graph_red[currentIndex].reserve(V);
-                        oldIndicesToNew[i] = currentIndex;
-                        currentIndex++;
-                    }
-                }
+            if (i != h && xVar.value(sol.data(), k, i, h) > used) {
+                used = xVar.value(sol.data(), k, i, h);
+                a = i;
             }
         }
-        // preenchimento do novo grafo
-        for (unsigned i = 0; i < sol_x_red.size(); i++) {
-            int ii = newIndicesToOld[i];
-            for (int j = 0; j < (int)newIndicesToOld.size(); j++) {
-                int jj = newIndicesToOld[j];
-                if (oldIndicesToNew[jj] != -1 && ii != jj) {
-                    double x_temp = sol[solver->getColIndex(x + lex(k) + UND + lex(ii) + UND + lex(jj))];
-                    if (round(x_temp) == 1) {
-                        graph_red[i].push_back(oldIndicesToNew[jj]); 
-                        sol_x_red[i].push_back(x_temp);
-                    }
-                }
-            }
-        }
-        // END OF Creating subgraph containing only visited vertices and visited edges
-        //////////////////////////////////////////////////////////////////////////////
+        if (a == -1) continue;
+
+        stats.maxFlowsSolved++;
+        if (maxFlow.solve(0, h) >= used - TOLERANCE_VIOLATION) continue;
 
-        vector<vector<int>> verticesInCut(1);
-        
-        if (graph_red.size() == 0) {
-            continue;
+        maxFlow.getSinkSide(sinkSide);
+        for (int i = 0; i < V; i++) {
+            if (sinkSide[i]) covered[i] = 1;
         }
+        for (auto& arc : arcs) {
+            if (!sinkSide[arc.first] && sinkSide[arc.second]) cuts.addCoef(xVar.col(k, arc.first, arc.second), 1);
+        }
+        cuts.addCoef(xVar.col(k, a, h), -1);
+        cuts.addCut('G', 0);
+    }
 
-        // Check if cut is connected
-        tempTime = Util::getWallTime();
+    stats.maxFlowTime += Util::getWallTime() - startTime;
+}
 
-        if (!addCuts) {
-            // verificação se o novo grafo possui o índice zero, ou seja, se passa pelo depósito
-            if (std::find(std::begin(newIndicesToOld), std::end(newIndicesToOld), 0) == std::end(newIndicesToOld)) {
-                addCuts = 1;
-                for (int i = 0; i < (int)oldIndicesToNew.size(); i++) {
-                    if (oldIndicesToNew[i] != -1)
-                        verticesInCut[0].push_back(oldIndicesToNew[i]);
-                }
-            }
-            // verificação se o novo grafo é conectado
-            else {
-                // retorna listas de vertices que não estão conectados ao primeiro grupo de vertices (encontra uma lista de vertices desconectados)
-                addCuts = !isConnected(graph_red, sol_x_red, verticesInCut[0]);
-                if (addCuts) {
-                    vector<vector<int>> verticesInCut2;
-                    // retorna listas de vertices que não foram visitados partindo do 0 (encontra tadas as listas de vertices desconectados)
-                    addCuts = disconnectedComponents(graph_red, sol_x_red, verticesInCut2);
-                    if (verticesInCut2.size() > 1) {
-                        verticesInCut.resize(verticesInCut2.size()+1);
-                        for (unsigned k = 1; k < verticesInCut.size(); k++) verticesInCut[k] = verticesInCut2[k-1];
-                    }
-                }
-            }
-        }
+/**
+ * Connectivity cuts over all trucks together. Every client of a set S must be served, and the trucks
+ * serving S deliver at most truckCapacity each, so at least ceil(demand(S) / truckCapacity) trucks (and
+ * never fewer than one) enter S:
+ *
+ *     sum_k sum_{i not in S, j in S} x[k][i][j] >= max(1, ceil(demand(S) / truckCapacity))
+ *
+ * The cuts are found from minimum cuts between the depot and each client, with the values of x summed
+ * over the trucks as capacities. Several trucks may serve the same clients, so unlike the per truck
+ * cuts the number of arcs used inside S is not bounded by |S| - 1.
+ */
+void ModelConcreteMixerTruckRouting::aggregatedConnectivityCuts(Span<double> sol, CutBuffer &cuts) {
+    CallbackStats& stats = threadStats();
+    double startTime = Util::getWallTime();
+
+    // Not the graph of fractionalConnectivityCuts, so that each keeps its flow from call to call
+    thread_local MaxFlow maxFlow;
+    buildArcGraph(maxFlow);
+
+    for (int a = 0; a < (int)arcs.size(); a++) {
+        double value = 0;
+        for (int k = 0; k < K; k++) value += std::max(0.0, xVar.value(sol.data(), k, arcs[a].first, arcs[a].second));
+        maxFlow.setCapacity(a, value);
+    }
+    stats.maxFlowCalls++;
 
-        if (addCuts) {
-            // criação dos cutting planes
-            for (int i = 0; i < (int)verticesInCut.size(); i++) {
-                SolverCut cut;
-                for (int j = 1; j < (int)verticesInCut[i].size(); j++) {
-                    if (newIndicesToOld[verticesInCut[i][j - 1]] != newIndicesToOld[verticesInCut[i][j]]) {
-                        // x_(j-1)_j
-                        int jj = solver->getColIndex(x + lex(k) + UND + lex(newIndicesToOld[verticesInCut[i][j - 1]]) + UND + lex(newIndicesToOld[verticesInCut[i][j]]));
-                        if (round(sol[jj]) == 1)
-                            cut.addCoef(jj, 1);
-
-                        // x_j_(j-1)
-                        jj = solver->getColIndex(x + lex(k) + UND + lex(newIndicesToOld[verticesInCut[i][j]]) + UND + lex(newIndicesToOld[verticesInCut[i][j - 1]]));
-                        if (round(sol[jj]) == 1)
-                            cut.addCoef(jj, 1);
-                    }
-                }
+    thread_local vector<char> sinkSide;
+    thread_local vector<char> covered;
+    covered.assign(V, 0);
+    for (int h = 1; h < V; h++) {
+        if (covered[h]) continue;
 
-                if (cut.getCoefs().size() > 0) {
-                    cut.setName("cut1g_" + lex(k));
-                    cut.setSense('L');
-                    cut.setRHS(cut.getCoefs().size() - 1);
-                    cuts.push_back(cut);
-                }
+        stats.maxFlowsSolved++;
+        double flow = maxFlow.solve(0, h);
+
+        maxFlow.getSinkSide(sinkSide);
+        double demandInCut = 0;
+        for (int j = 1; j < V; j++) {
+            if (sinkSide[j]) demandInCut += demand[j];
+        }
+        double trucks = 1;
+        if (truckCapacity > 0) trucks = std::max(1.0, ceil(demandInCut / truckCapacity - TOLERANCE));
+        if (flow >= trucks - TOLERANCE_VIOLATION) continue;
+
+        for (int i = 0; i < V; i++) {
+            if (sinkSide[i]) covered[i] = 1;
+        }
+        for (int k = 0; k < K; k++) {
+            for (auto& arc : arcs) {
+                if (!sinkSide[arc.first] && sinkSide[arc.second]) cuts.addCoef(xVar.col(k, arc.first, arc.second), 1);
             }
         }
-        
-        bfsTime += (Util::getWallTime() - tempTime);
+        cuts.addCut('G', trucks);
     }
+
+    stats.maxFlowTime += Util::getWallTime() - startTime;
 }
 
-int ModelConcreteMixerTruckRouting::isConnected(const vector<vector<int>> &graph, const vector<vector<double>> &distance, vector<int> &notConnected) { 
-    notConnected.resize(graph.size());
-    std::fill(notConnected.begin(), notConnected.end(), 1);
-    vector<int> visitQueue(1);
-    visitQueue[0] = 0;
-    notConnected[0] = 0;
-
-    while (visitQueue.size() > 0) {
-        int i = visitQueue[0];
-        for (int j = 0; j < (int)graph[i].size(); j++) {
-            int jj = graph[i][j];
-            if (round(distance[i][j]) == 1) {
-                 if (notConnected[jj] == 1) {
-                    visitQueue.push_back(jj);
-                    notConnected[jj] = 0;
-                 }
+void ModelConcreteMixerTruckRouting::connectivityCuts(Span<double> sol, int k, CutBuffer &cuts) {
+
+    // Reused by every call of the thread
+    thread_local vector<int> newIndicesToOld; // mapeamento do grafo novo para o original (dados do grafo original)
+    thread_local vector<int> oldIndicesToNew; // mapeamento do grafo original para o novo (dados do grafo novo)
+    thread_local CSRGraph    graph_red; // índices e soluções de x avaliados
+    thread_local GraphSearch search;
+    oldIndicesToNew.resize(V);
+    
+    int addCuts = 0;
+    
+    //////////////////////////////////////////////////////////////////////////////
+    // Creating subgraph containing only visited vertices and visited edges
+    //
+    // Reduce graph to contain only those vertices and edges with values on them
+    // Map original indices to new
+    // Map new indices to original
+    // Create list of vertices in sol_y or something
+    // Create graph (edges)
+    // Create capacity graph (sol_x or something)
+    double tempTime = Util::getWallTime();
+    int currentIndex = 0;
+    newIndicesToOld.clear();
+    std::fill(oldIndicesToNew.begin(), oldIndicesToNew.end(), -1);
+
+    // criação da estrutura do novo grafo
+    // The columns of truck k are contiguous, in the order of (i, j). A vertex left by several arcs is added once
+    for (int c = xVar.firstColOf(k); c < xVar.firstColOf(k + 1); c++) {
+        int i = xVar.getTuple(c - xVar.getFirstCol())[1];
+        if (round(sol[c]) == 1 && oldIndicesToNew[i] == -1) {
+            newIndicesToOld.push_back(i);
+            oldIndicesToNew[i] = currentIndex;
+            currentIndex++;
+        }
+    }
+    // preenchimento do novo grafo
+    graph_red.reset(currentIndex);
+    for (int i = 0; i < currentIndex; i++) {
+        int ii = newIndicesToOld[i];
+        for (int j = 0; j < (int)newIndicesToOld.size(); j++) {
+            int jj = newIndicesToOld[j];
+            if (oldIndicesToNew[jj] != -1 && ii != jj) {
+                double x_temp = xVar.value(sol.data(), k, ii, jj);
+                if (round(x_temp) == 1) graph_red.addArc(i, oldIndicesToNew[jj], x_temp);
             }
         }
-        visitQueue.erase(visitQueue.begin());
     }
+    graph_red.build();
+    // END OF Creating subgraph containing only visited vertices and visited edges
+    //////////////////////////////////////////////////////////////////////////////
 
-    int numDisconnected = 0;
+    vector<vector<int>> verticesInCut(1);
     
-    for (unsigned i = 0; i < notConnected.size(); i++) {
-        if (notConnected[i] == 1) {
-            notConnected[numDisconnected] = i;
-            numDisconnected++;
-        }
+    if (graph_red.getNumNodes() == 0) {
+        return;
     }
 
-    notConnected.resize(numDisconnected);
-    return numDisconnected == 0;
-}
-
-int ModelConcreteMixerTruckRouting::disconnectedComponents(const vector<vector<int>> &graph, const vector<vector<double>> &distance, vector<vector<int>> &components) { 
-    if (graph.size() == 0) return 0;        
+    // Check if cut is connected
+    tempTime = Util::getWallTime();
 
-    components.resize(1);
-    vector<int> visited(graph.size());
-    std::fill(visited.begin()+1, visited.end(), 0);
-
-    int verticesLeft = (int) graph.size();
-    int minIndexLeft = 0;
-    int currentComponent = 0;
-
-    while (minIndexLeft != -1) {
-        components[currentComponent].reserve(verticesLeft);
-        vector<int> visitQueue(1);
-
-        visitQueue[0] = minIndexLeft;
-        components[currentComponent].push_back(minIndexLeft);
-        visited[minIndexLeft] = 1;
-        verticesLeft--;
- 
-        while (visitQueue.size() > 0) {
-            int i = visitQueue[0];
-            for (int j = 0; j < (int)graph[i].size(); j++) {
-                int jj = graph[i][j];
-                if (visited[jj] == 0) {
-                    visitQueue.push_back(jj);
-                    components[currentComponent].push_back(jj);
-                    visited[jj] = 1;
-                    verticesLeft--;
-                }
+    if (!addCuts) {
+        // verificação se o novo grafo possui o índice zero, ou seja, se passa pelo depósito
+        if (std::find(std::begin(newIndicesToOld), std::end(newIndicesToOld), 0) == std::end(newIndicesToOld)) {
+            addCuts = 1;
+            for (int i = 0; i < (int)oldIndicesToNew.size(); i++) {
+                if (oldIndicesToNew[i] != -1)
+                    verticesInCut[0].push_back(oldIndicesToNew[i]);
             }
-            visitQueue.erase(visitQueue.begin());
         }
-       
-        int found = 0;
-        for (unsigned i = minIndexLeft + 1; i < graph.size(); i++) {
-            if (visited[i] == 0) {
-                minIndexLeft = i;
-                found = 1;
-                break;
+        // verificação se o novo grafo é conectado
+        else {
+            // retorna listas de vertices que não estão conectados ao primeiro grupo de vertices (encontra uma lista de vertices desconectados)
+            addCuts = !isConnected(graph_red, search, verticesInCut[0]);
+            if (addCuts) {
+                vector<vector<int>> verticesInCut2;
+                // retorna listas de vertices que não foram visitados partindo do 0 (encontra tadas as listas de vertices desconectados)
+                addCuts = disconnectedComponents(graph_red, search, verticesInCut2);
+                if (verticesInCut2.size() > 1) {
+                    verticesInCut.resize(verticesInCut2.size()+1);
+                    for (unsigned k = 1; k < verticesInCut.size(); k++) verticesInCut[k] = verticesInCut2[k-1];
+                }
             }
         }
-        if (!found) {
-            minIndexLeft = -1;
-        } else {
-            currentComponent++;
-            components.resize(components.size()+1);
+    }
+
+    if (addCuts) {
+        // criação dos cutting planes
+        // Each set S of clients not reached from the depot has an arc (a, h) used inside it but is not
+        // entered, which violates the cut of fractionalConnectivityCuts (cut1g_k):
+        //
+        //     sum_{i not in S, j in S} x[k][i][j] - x[k][a][h] >= 0
+        thread_local vector<char> inS;
+        for (int c = 0; c < (int)verticesInCut.size(); c++) {
+            inS.assign(V, 0);
+            for (int v : verticesInCut[c]) inS[newIndicesToOld[v]] = 1;
+            if (inS[0]) continue;
+
+            int a = -1;
+            int h = -1;
+            double entering = 0;
+            for (auto& arc : arcs) {
+                if (!inS[arc.second]) continue;
+                double value = xVar.value(sol.data(), k, arc.first, arc.second);
+                if (!inS[arc.first]) {
+                    entering += value;
+                } else if (a == -1 && round(value) == 1) {
+                    a = arc.first;
+                    h = arc.second;
+                }
+            }
+            if (a == -1 || entering > 1 - TOLERANCE_VIOLATION) continue;
+
+            for (auto& arc : arcs) {
+                if (!inS[arc.first] && inS[arc.second]) cuts.addCoef(xVar.col(k, arc.first, arc.second), 1);
+            }
+            cuts.addCoef(xVar.col(k, a, h), -1);
+            cuts.addCut('G', 0);
         }
+    }
+    
+    threadStats().bfsTime += (Util::getWallTime() - tempTime);
+}
+
+// Every arc of the graph is used by the truck
+int ModelConcreteMixerTruckRouting::isConnected(const CSRGraph &graph, GraphSearch &search, vector<int> &notConnected) { 
+    search.clear(graph.getNumNodes());
+    notConnected.clear();
+    search.bfs(graph, 0, notConnected);
 
+    notConnected.clear();
+    for (int i = 0; i < graph.getNumNodes(); i++) {
+        if (!search.isVisited(i)) notConnected.push_back(i);
+    }
+    return notConnected.empty();
+}
+
+int ModelConcreteMixerTruckRouting::disconnectedComponents(const CSRGraph &graph, GraphSearch &search, vector<vector<int>> &components) { 
+    if (graph.getNumNodes() == 0) return 0;        
+
+    // Components are reached from the lowest vertex left, the first one (that of vertex 0) is not returned
+    search.clear(graph.getNumNodes());
+    components.resize(1);
+    components[0].clear();
+    search.bfs(graph, 0, components[0]);
+    for (int minIndexLeft = 1; minIndexLeft < graph.getNumNodes(); minIndexLeft++) {
+        if (search.isVisited(minIndexLeft)) continue;
+        components.push_back(vector<int>());
+        search.bfs(graph, minIndexLeft, components.back());
     }
 
     components.erase(components.begin());
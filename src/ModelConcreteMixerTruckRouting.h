@@ -4,6 +4,9 @@
 
 #include "Model.h"
 #include "Solution.h"
+#include "VarFamily.h"
+#include "ThreadPool.h"
+#include "MaxFlow.h"
 
 class ModelConcreteMixerTruckRouting : public Model {
 
@@ -13,6 +16,11 @@ class ModelConcreteMixerTruckRouting : public Model {
         string x;
         string y;
         string z;
+
+        // Variables x[k][i][j] (i != j), y[k] and z[k][j] (j != 0)
+        VarFamily<3> xVar;
+        VarFamily<1> yVar;
+        VarFamily<2> zVar;
         
         // Solution values
         int V;
@@ -21,20 +29,38 @@ class ModelConcreteMixerTruckRouting : public Model {
         vector<double> sol_y;
         vector<vector<double>> sol_z;
 
+        // Demand of each client and capacity of the trucks, for the aggregated cuts
+        vector<double> demand;
+        double truckCapacity;
+
+        // Admissible arcs of the data, the only ones with an x column (for each truck)
+        vector<std::pair<int, int>> arcs;
+
         virtual void reserveSolutionSpace(const Data* data);
         virtual void readSolution        (const Data* data);
         virtual void assignWarmStart     (const Data* data);
         virtual void createModel         (const Data* data);
         
         void printSolutionVariables(int digits = 5, int decimals = 2);
-        vector<SolverCut> separationAlgorithm(vector<double> sol);
-        void connectivityCuts(const vector<double> &sol, vector<SolverCut> &cuts);
-        int disconnectedComponents(const vector<vector<int>> &graph, const vector<vector<double>> &distance, vector<vector<int>> &components);
-        int isConnected(const vector<vector<int>> &graph, const vector<vector<double>> &distance, vector<int> &notConnected);
+        void separationAlgorithm(Span<double> sol, CutBuffer& cuts);
+
+        // Separation of one truck, trucks may be separated by different threads at the same time
+        typedef void (ModelConcreteMixerTruckRouting::*TruckSeparation)(Span<double> sol, int k, CutBuffer& cuts);
+        ThreadPool* separationPool;
+        bool parallelSeparationForced;
+        void separateTrucks(Span<double> sol, CutBuffer& cuts, TruckSeparation separateTruck);
+        void connectivityCuts(Span<double> sol, int k, CutBuffer &cuts);
+        void fractionalConnectivityCuts(Span<double> sol, int k, CutBuffer &cuts);
+        void buildArcGraph(MaxFlow &maxFlow);
+        // Cuts over all trucks together, as well as those of each truck (see aggregated_connectivity_cuts)
+        bool aggregatedCuts;
+        void aggregatedConnectivityCuts(Span<double> sol, CutBuffer &cuts);
+        int disconnectedComponents(const CSRGraph &graph, GraphSearch &search, vector<vector<int>> &components);
+        int isConnected(const CSRGraph &graph, GraphSearch &search, vector<int> &notConnected);
         
     public:
         
-        ModelConcreteMixerTruckRouting();
+        ModelConcreteMixerTruckRouting(RunContext* ctx = NULL);
 
         virtual ~ModelConcreteMixerTruckRouting();
 
@@ -0,0 +1,90 @@
+/**
+ * ModelIR.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "ModelIR.h"
+
+ModelIR::ModelIR() : BuildBuffer() {
+    maximisation = false;
+}
+
+ModelIR::~ModelIR() {
+}
+
+void ModelIR::addColFormatter(int first, int num, NameFormatter format) {
+    NameFormatterBlock block;
+    block.first  = first;
+    block.num    = num;
+    block.format = format;
+    colFormatters.push_back(block);
+}
+
+void ModelIR::addRowFormatter(int first, int num, NameFormatter format) {
+    NameFormatterBlock block;
+    block.first  = first;
+    block.num    = num;
+    block.format = format;
+    rowFormatters.push_back(block);
+}
+
+void ModelIR::clear() {
+    BuildBuffer::clear();
+    colFormatters.clear();
+    rowFormatters.clear();
+    maximisation = false;
+}
+
+bool ModelIR::isMIP() const {
+    for (int i = 0; i < getNumCols(); i++) if (getTypes()[i] != 'C') return true;
+    return false;
+}
+
+void ModelIR::getRowActivities(const double* x, vector<double>& activities) const {
+    activities.assign(getNumRows(), 0.0);
+    const int*    ind = getRowInd();
+    const double* val = getRowVal();
+    for (int r = 0; r < getNumRows(); r++) {
+        double activity = 0;
+        for (int k = getRowBegin(r); k < getRowEnd(r); k++) activity += val[k] * x[ind[k]];
+        activities[r] = activity;
+    }
+}
+
+double ModelIR::getMaxViolation(const double* x) const {
+    double violation = 0;
+    for (int i = 0; i < getNumCols(); i++) {
+        violation = std::max(violation, getLower()[i] - x[i]);
+        violation = std::max(violation, x[i] - getUpper()[i]);
+    }
+
+    vector<double> activities;
+    getRowActivities(x, activities);
+    for (int r = 0; r < getNumRows(); r++) {
+        double diff = activities[r] - getRhs()[r];
+        if      (getSense()[r] == 'L') violation = std::max(violation,  diff);
+        else if (getSense()[r] == 'G') violation = std::max(violation, -diff);
+        else                           violation = std::max(violation, fabs(diff));
+    }
+    return violation;
+}
+
+void ModelIR::printStatistics() const {
+    int numBinary = 0, numInteger = 0;
+    for (int i = 0; i < getNumCols(); i++) {
+        if      (getTypes()[i] == 'B') numBinary++;
+        else if (getTypes()[i] == 'I') numInteger++;
+    }
+    int numL = 0, numE = 0, numG = 0;
+    for (int r = 0; r < getNumRows(); r++) {
+        if      (getSense()[r] == 'L') numL++;
+        else if (getSense()[r] == 'E') numE++;
+        else                           numG++;
+    }
+    printf("Model: %s, %d columns (%d binary, %d integer), %d rows (%d <=, %d ==, %d >=), %d nonzeros, %.2f KB\n",
+           maximisation ? "max" : "min", getNumCols(), numBinary, numInteger, getNumRows(), numL, numE, numG, 
+           getNumNonZeros(), getMemoryUsage() / 1024.0);
+}
@@ -0,0 +1,60 @@
+/**
+ * ModelIR.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef MODELIR_H
+#define MODELIR_H
+
+#include "BuildBuffer.h"
+#include "NameIndex.h"
+
+/**
+ * Solver independent representation of a model: columns (objective, bounds and types),
+ * rows in CSR form, objective sense and names.
+ *
+ * A model is built once into a ModelIR and then loaded in one shot into any solver
+ * (Solver::loadModel), or inspected without one. Names are either explicit (one per
+ * column or row) or given by blocks of formatters. Formatters may refer to the model
+ * that built the IR (e.g. to a VarFamily), which must outlive it.
+ */
+class ModelIR : public BuildBuffer {
+
+    private:
+
+        bool maximisation;
+
+        vector<NameFormatterBlock> colFormatters;
+        vector<NameFormatterBlock> rowFormatters;
+
+    public:
+
+        ModelIR();
+        ~ModelIR();
+
+        void setMaximisation(bool isMax) { maximisation = isMax; }
+        void addColFormatter(int first, int num, NameFormatter format);
+        void addRowFormatter(int first, int num, NameFormatter format);
+        void clear();
+
+        bool isMaximisation() const { return maximisation; }
+        bool isMIP()          const;
+
+        const vector<NameFormatterBlock>& getColFormatters() const { return colFormatters; }
+        const vector<NameFormatterBlock>& getRowFormatters() const { return rowFormatters; }
+
+        // Row r has nonzeros [getRowBegin(r), getRowEnd(r)) in getRowInd() and getRowVal()
+        int getRowBegin(int r) const { return getRowBeg()[r]; }
+        int getRowEnd  (int r) const { return r + 1 < getNumRows() ? getRowBeg()[r+1] : getNumNonZeros(); }
+
+        // x has one value per column. Returns the largest violation of a bound or row
+        void   getRowActivities(const double* x, vector<double>& activities) const;
+        double getMaxViolation (const double* x) const;
+
+        void printStatistics() const;
+};
+
+#endif
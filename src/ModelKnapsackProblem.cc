@@ -7,7 +7,7 @@
  * INITIAL METHODS
  */
 
-ModelKnapsackProblem::ModelKnapsackProblem() : Model(){
+ModelKnapsackProblem::ModelKnapsackProblem(RunContext* ctx) : Model(ctx){
     V = 0;
     x = "x";
 }
@@ -20,12 +20,12 @@ void ModelKnapsackProblem::execute(const Data* data) {
     float startTime = Util::getTime();
     
     if (debug > 1) solver->printSolverName();
-    createModel(data);
+    buildModel(data);
     reserveSolutionSpace(data);
     assignWarmStart(data);
     setSolverParameters(1);
 
-    solver->addInfoCallback(this);
+    addInfoCallback();
 
     solve(data);
     totalTime = Util::getTime() - startTime;
@@ -34,9 +34,9 @@ void ModelKnapsackProblem::execute(const Data* data) {
 
 void ModelKnapsackProblem::printSolutionVariables(int digits, int decimals) {
     if (debug) {
-        printf("\nSolution: \n");
+        context->print("\nSolution: \n");
         for (int i = 0; i < V; i++) {
-            printf("  x%d = %.0f\n", i, sol_x[i]);
+            context->print("  x%d = %.0f\n", i, sol_x[i]);
     
         }
     }
@@ -52,7 +52,7 @@ void ModelKnapsackProblem::readSolution(const Data* data) {
     solution->resetSolution();
     solution->setSolutionStatus(solver->solutionExists(), solver->isOptimal(),  solver->isInfeasible(), solver->isUnbounded());
     if (!solver->solutionExists()) {
-        if (debug) printf("Solution does not exist\n");        
+        if (debug) context->print("Solution does not exist\n");        
     } else {
         solution->setValue    (solver->getObjValue() );
         solution->setBestBound(solver->getBestBound());
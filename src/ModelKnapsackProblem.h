@@ -24,7 +24,7 @@ class ModelKnapsackProblem : public Model {
         
     public:
         
-        ModelKnapsackProblem();
+        ModelKnapsackProblem(RunContext* ctx = NULL);
 
         virtual ~ModelKnapsackProblem();
 
@@ -8,7 +8,7 @@
  * INITIAL METHODS
 */
 
-ModelMotivatingProblem::ModelMotivatingProblem() : Model(){
+ModelMotivatingProblem::ModelMotivatingProblem(RunContext* ctx) : Model(ctx){
     V = 0;
     x = "x";
 }
@@ -21,12 +21,12 @@ void ModelMotivatingProblem::execute(const Data* data) {
     float startTime = Util::getTime();
     
     if (debug > 1) solver->printSolverName();
-    createModel(data);
+    buildModel(data);
     reserveSolutionSpace(data);
     assignWarmStart(data);
     setSolverParameters(1);
 
-    solver->addInfoCallback(this);
+    addInfoCallback();
 
     solve(data);
     totalTime = Util::getTime() - startTime;
@@ -35,9 +35,9 @@ void ModelMotivatingProblem::execute(const Data* data) {
 
 void ModelMotivatingProblem::printSolutionVariables(int digits, int decimals) {
     if (debug) {
-        printf("\nSolution: \n");
+        context->print("\nSolution: \n");
         for (int i = 0; i < V; i++) {
-            printf("  x%d = %.0f\n", i, sol_x[i]);
+            context->print("  x%d = %.0f\n", i, sol_x[i]);
     
         }
     }
@@ -53,7 +53,7 @@ void ModelMotivatingProblem::readSolution(const Data* data) {
     solution->resetSolution();
     solution->setSolutionStatus(solver->solutionExists(), solver->isOptimal(),  solver->isInfeasible(), solver->isUnbounded());
     if (!solver->solutionExists()) {
-        if (debug) printf("Solution does not exist\n");        
+        if (debug) context->print("Solution does not exist\n");        
     } else {
         solution->setValue    (solver->getObjValue() );
         solution->setBestBound(solver->getBestBound());
@@ -28,7 +28,7 @@ class ModelMotivatingProblem : public Model {
         
     public:
         
-        ModelMotivatingProblem();
+        ModelMotivatingProblem(RunContext* ctx = NULL);
 
         virtual ~ModelMotivatingProblem();
 
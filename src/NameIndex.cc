@@ -0,0 +1,116 @@
+/**
+ * NameIndex.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "NameIndex.h"
+#include <string.h>
+
+NameIndex::NameIndex() {
+    clear();
+}
+
+NameIndex::~NameIndex() {
+}
+
+void NameIndex::clear() {
+    pool.clear();
+    offsets.clear();
+    slotOffsets.assign(16, -1);
+    slotIndices.assign(16, -1);
+    numNames = 0;
+}
+
+// FNV-1a
+unsigned long long NameIndex::hash(const char* name, size_t length) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        h ^= (unsigned char) name[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * Returns the slot holding name or, if name is not in the table, the empty
+ * slot where it should be inserted
+ */
+int NameIndex::findSlot(const char* name, size_t length) const {
+    int mask = (int)slotOffsets.size() - 1;
+    int slot = (int)(hash(name, length) & mask);
+    while (slotOffsets[slot] != -1) {
+        const char* stored = pool.c_str() + slotOffsets[slot];
+        if (stored[length] == '\0' && memcmp(stored, name, length) == 0) return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void NameIndex::rehash(int numSlots) {
+    vector<int> oldOffsets;
+    vector<int> oldIndices;
+    oldOffsets.swap(slotOffsets);
+    oldIndices.swap(slotIndices);
+    slotOffsets.assign(numSlots, -1);
+    slotIndices.assign(numSlots, -1);
+
+    for (unsigned i = 0; i < oldOffsets.size(); i++) {
+        if (oldOffsets[i] == -1) continue;
+        const char* name = pool.c_str() + oldOffsets[i];
+        int slot = findSlot(name, strlen(name));
+        slotOffsets[slot] = oldOffsets[i];
+        slotIndices[slot] = oldIndices[i];
+    }
+}
+
+/**
+ * Same semantics as map[name] = index: if name already exists it now refers to index.
+ */
+void NameIndex::add(const string& name, int index) {
+    if (index < 0) Util::throwInvalidArgument("Error: Invalid index %d for name %s.", index, name.c_str());
+
+    // Keep load factor below 1/2
+    if (2 * (numNames + 1) > (int)slotOffsets.size()) rehash(2 * (int)slotOffsets.size());
+
+    int slot = findSlot(name.c_str(), name.size());
+    int offset;
+    if (slotOffsets[slot] == -1) {
+        offset = (int)pool.size();
+        pool.append(name);
+        pool.push_back('\0');
+        slotOffsets[slot] = offset;
+        numNames++;
+    } else {
+        offset = slotOffsets[slot];
+        // The old index keeps no name, rather than one that maps elsewhere
+        int oldIndex = slotIndices[slot];
+        if (oldIndex != index && offsets[oldIndex] == offset) offsets[oldIndex] = -1;
+    }
+    slotIndices[slot] = index;
+
+    if (index >= (int)offsets.size()) offsets.resize(index + 1, -1);
+    offsets[index] = offset;
+}
+
+int NameIndex::find(const string& name) const {
+    int slot = findSlot(name.c_str(), name.size());
+    return slotOffsets[slot] == -1 ? -1 : slotIndices[slot];
+}
+
+const char* NameIndex::getName(int index) const {
+    if (index < 0 || index >= (int)offsets.size() || offsets[index] == -1) return NULL;
+    return pool.c_str() + offsets[index];
+}
+
+size_t NameIndex::getMemoryUsage() const {
+    return pool.capacity() + 
+           sizeof(int) * (offsets.capacity() + slotOffsets.capacity() + slotIndices.capacity());
+}
+
+double NameIndex::getBytesPerName() const {
+    if (numNames == 0) return 0;
+    return (double) getMemoryUsage() / numNames;
+}
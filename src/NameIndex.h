@@ -0,0 +1,70 @@
+/**
+ * NameIndex.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include "Util.h"
+#include <functional>
+
+// Generates the name of the i-th element (0-based) of a block of columns or rows
+typedef std::function<string(int)> NameFormatter;
+
+struct NameFormatterBlock {
+    int first;
+    int num;
+    NameFormatter format;
+};
+
+/**
+ * Bidirectional map between names and indices, O(1) in both directions.
+ *
+ * Every name is stored once in a single pool. An open addressing hash table
+ * maps names to indices and a dense vector maps indices to names.
+ */
+class NameIndex {
+
+    private:
+
+        // All names, each one terminated by '\0'
+        string pool;
+
+        // index -> offset of its name in pool (-1 if the index has no name)
+        vector<int> offsets;
+
+        // Hash table, linear probing. Each slot stores the offset of the
+        // name in pool and its index, offset -1 means the slot is empty
+        vector<int> slotOffsets;
+        vector<int> slotIndices;
+
+        int numNames;
+
+        static unsigned long long hash(const char* name, size_t length);
+        int  findSlot(const char* name, size_t length) const;
+        void rehash(int numSlots);
+
+    public:
+
+        NameIndex();
+        ~NameIndex();
+
+        void add(const string& name, int index);
+        void clear();
+
+        // -1 if name was not found
+        int find(const string& name) const;
+
+        // NULL if index has no name
+        const char* getName(int index) const;
+
+        int    getNumNames()       const { return numNames;                 }
+        size_t getMemoryUsage()    const;
+        double getBytesPerName()   const;
+};
+
+#endif
@@ -30,6 +30,7 @@ class Option {
         virtual void checkOption(string str, string optionName) {}
         virtual bool wasChanged() {return false;}
         virtual string getValueAsString() {return "";};
+        virtual Option* clone() { return new Option(*this); }
     
         // Non virtual methods
         string getName()        { return name; }
@@ -52,6 +53,7 @@ class BoolOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new BoolOption(*this); }
         bool getValue() { return value; }
 };
 
@@ -71,6 +73,7 @@ class IntOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new IntOption(*this); }
         int getValue() { return value; }
 };
 
@@ -90,6 +93,7 @@ class DoubleOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new DoubleOption(*this); }
         double getValue() { return value; }
 };
 
@@ -108,6 +112,7 @@ class StringOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new StringOption(*this); }
         string getValue() { return value; }
 };
 
@@ -127,6 +132,7 @@ class ArrayOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new ArrayOption(*this); }
         vector<int> getValue() { return value; }
 };
 
@@ -146,6 +152,7 @@ class DoubleArrayOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new DoubleArrayOption(*this); }
         vector<double> getValue() { return value; }
 };
 
@@ -168,6 +175,7 @@ class MatrixOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new MatrixOption(*this); }
         vector<vector<int>> getValue() { return value; }
 };
 
@@ -187,6 +195,7 @@ class DoubleMatrixOption : public Option {
         virtual void checkOption(string str, string optionName);
         virtual bool wasChanged();
         virtual string getValueAsString();
+        virtual Option* clone() { return new DoubleMatrixOption(*this); }
         vector<vector<double>> getValue() { return value; }
 };
 
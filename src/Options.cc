@@ -28,6 +28,13 @@ Options::Options() {
     assignDefaultValues();
 }
 
+// Independent copy, e.g. for a run with its own settings
+Options::Options(const Options& other) {
+    for (unsigned i = 0; i < other.options.size(); i++) options.push_back(other.options[i]->clone());
+    optionsMap = other.optionsMap;
+    allowedWithSettingsFile = other.allowedWithSettingsFile;
+}
+
 Options::~Options() {
     for (int i = 0; i < (int)options.size(); i++) {
         delete(options[i]);
@@ -51,7 +58,15 @@ void Options::assignDefaultValues() {
 
 
     vector<string> solverValues;
+#ifdef USE_CPLEX
     solverValues.push_back("cplex");
+    string defaultSolver = "cplex";
+#else
+    string defaultSolver = "native";
+#endif
+    solverValues.push_back("simplex");
+    solverValues.push_back("native");
+    solverValues.push_back("record");
     
     vector<string> modelValues;
     modelValues.push_back("toy");
@@ -81,7 +96,8 @@ void Options::assignDefaultValues() {
     options.push_back(new StringOption("model",  "Which model to solve", 1, "toy", modelValues));
     
     // Solver options 
-    options.push_back(new StringOption("solver",             "Choose which solver to use [Default: cplex)", 1, "cplex", solverValues));
+    options.push_back(new StringOption("solver",             "Choose which solver to use, cplex, simplex (built-in LP solver) native (built-in simplex and parallel branch-and-bound) or record (calls are only recorded, nothing is solved) [Default: cplex if available, otherwise native]", 1, defaultSolver, solverValues));
+    options.push_back(new BoolOption  ("lp_relaxation",      "If (1) integrality is dropped and the linear relaxation is solved [Default: 0]", 1, 0));
     options.push_back(new IntOption   ("solver_debug_level", "Choose the solver debug level [Default: 2]", 1, 2, 5, 0));
     options.push_back(new IntOption   ("time_limit",         "Time limit for the solver (in seconds, if zero time limit is not set)", 1, 21600, imax,  0));
     options.push_back(new BoolOption  ("presolve",           "Presolve is (0) disabled or (1) enabled [Default: 1]",                               1,  1));
@@ -96,6 +112,20 @@ void Options::assignDefaultValues() {
     options.push_back(new IntOption   ("solver_parallelism",     "(1) on, (0) off, (2) non-deterministic [Default: 0]",               1,     0,    2,  0));
     options.push_back(new IntOption   ("solver_threads",         "Number of threads [Default: 0]",                                    1,     0, imax,  0));  
     options.push_back(new IntOption   ("mip_strategy",       "Dynamic switch or branch-and-cut [Default: 0 (auto)]",                  1,     0,    2,  0));  
+    options.push_back(new BoolOption  ("solver_names",       "(1) Names are passed to the solver as columns and rows are added, (0) they are only generated when needed [Default: 1]", 1, 1));
+    options.push_back(new BoolOption  ("model_ir",           "(1) Models are built into a solver independent representation and loaded into the solver in one shot, (0) they are built directly in the solver [Default: 1]", 1, 1));
+    options.push_back(new IntOption   ("cplex_env_pool",     "CPLEX environments kept open for reuse by later models, each one has a license checked out (0 opens one per model) [Default: 1]", 1, 1, imax, 0));
+    options.push_back(new DoubleOption("good_enough_solution", "If not 0, solving stops as soon as a solution at least this good is found [Default: 0]", 1, 0, 1e20, -1e20));
+    options.push_back(new IntOption   ("portfolio_workers",  "If more than 1, this many solver configurations race on the same model, sharing incumbents, and solver_threads is split among them (needs model_ir) [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new StringOption("trace_file",         "If not empty, every call to the solver is recorded into this binary trace file", 1, "", empty));
+    options.push_back(new StringOption("replay_trace",       "If not empty, this trace file is replayed into the solver instead of solving a model", 1, "", empty));
+    options.push_back(new IntOption   ("build_buffer_mb",    "Columns and rows are buffered and added to the solver in bulk, up to this many MB at a time (0 adds them one by one) [Default: 64]", 1, 64, imax, 0));
+    options.push_back(new IntOption   ("cut_pool_age",       "Cuts of the model's separation are pooled and checked before it runs again, those not violated in this many checks are dropped (0 disables the pool) [Default: 100]", 1, 100, imax, 0));
+    options.push_back(new IntOption   ("cut_budget",         "At most this many user cuts of the model are added per separation round, the best by efficacy (0 for no limit) [Default: 50]", 1, 50, imax, 0));
+    options.push_back(new DoubleOption("cut_max_parallelism", "User cuts more parallel than this (cosine) to a better one added in the same round are dropped (1 keeps them all) [Default: 0.99]", 1, 0.99, 1, 0));
+    options.push_back(new IntOption   ("separation_threads", "Threads a model may use to separate one point, e.g. one truck each in the concrete mixer model. 0 for the number of cores, only used on large models, 1 separates on the callback thread [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new BoolOption  ("aggregated_connectivity_cuts", "(1) The concrete mixer model also separates connectivity cuts over all trucks together, requiring the trucks entering a set of clients to be able to carry its demand [Default: 0]", 1, 0));
+    options.push_back(new DoubleOption("max_arc_distance",   "If not 0, the concrete mixer model has no arcs between clients farther apart than this, which may cut off optimal routes [Default: 0]", 1, 0, 1e20, 0));
 
 
     // Solver cuts
@@ -320,7 +350,10 @@ void Options::readSettingsFile(string filename) {
 }
 
 void Options::specificChecks() {
-    if (Options::getInstance()->getStringOption("input").empty()) Util::stop("Error: Input file was not provided");
+    if (getStringOption("input").empty() && getStringOption("replay_trace").empty()) 
+        Util::stop("Error: Input file was not provided");
+    if (getIntOption("portfolio_workers") > 1 && !getBoolOption("model_ir"))
+        Util::stop("Error: portfolio_workers needs model_ir, solvers in the race are loaded from the model representation");
     
 }
 
@@ -63,12 +63,16 @@ class Options {
         
         // Create and destroy
         Options();
+        Options(const Options& other);
+        Options& operator=(const Options& other) = delete;
         ~Options();
         void factory();
         static void finalise();
 
         // parse options
         void parseOptions(int numOptions, char* pairs[]);
+        // Changes a single option, value as it would be given in the command line
+        void setOption(string optionName, string value) { changeOptionValue(optionName, value); }
         
         // print debug information
         void print();
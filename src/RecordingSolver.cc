@@ -0,0 +1,889 @@
+/**
+ * RecordingSolver.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "RecordingSolver.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#define TRACE_MAGIC   "OPTTRACE"
+#define TRACE_VERSION 1
+
+// Kind of callback registered, recorded with TRACE_CALLBACK
+enum TraceCallback {
+    TRACE_LAZY_CALLBACK = 0,
+    TRACE_USER_CUT_CALLBACK,
+    TRACE_INCUMBENT_CALLBACK,
+    TRACE_INFO_CALLBACK,
+    TRACE_NODE_CALLBACK,
+    TRACE_SOLVE_CALLBACK
+};
+
+static const char* traceOpNames[TRACE_NUM_OPS] = {
+    "deleteAndRecreateProblem", "changeObjectiveSense", "addVariable", "addVariables", "addBinaryVariable",
+    "addBinaryVariables", "addIntegerVariable", "addIntegerVariables", "addRow (names)", "addRow",
+    "addLazyConstraint", "addUserCut", "setColBounds", "setColNames", "setRowNames", "beginBuild", "endBuild",
+    "loadModel", "setPriorityInBranching", "setVariablesWarmStart", "refineMIPStart", "relax", "solve",
+    "getColSolution", "setTimeLimit", "setNodeLimit", "enablePresolve", "setLPMethod", "setFeasibilityPump",
+    "setSolverRandomSeed", "setSolverCuts", "setMIPEmphasis", "setMIPStrategy", "setSolverParallelism",
+    "setSolverLocalBranching", "setNodeHeuristic", "setProbingLevel", "callback", "callback cut (as addRow)"
+};
+
+/**
+ * Reads back what RecordingSolver::put* wrote
+ */
+class TraceReader {
+
+    private:
+
+        const vector<char>& trace;
+        size_t pos;
+
+        void need(size_t bytes) {
+            if (pos + bytes > trace.size()) Util::throwInvalidArgument("Error: Trace is truncated at byte %lu.", (unsigned long)pos);
+        }
+
+    public:
+
+        TraceReader(const vector<char>& t) : trace(t), pos(0) {}
+
+        bool atEnd() { return pos >= trace.size(); }
+
+        template<typename T> T get() {
+            need(sizeof(T));
+            T value;
+            memcpy(&value, &trace[pos], sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        template<typename T> vector<T> getArray() {
+            int num = get<int>();
+            need(sizeof(T) * num);
+            vector<T> values(num);
+            if (num > 0) memcpy(values.data(), &trace[pos], sizeof(T) * num);
+            pos += sizeof(T) * num;
+            return values;
+        }
+
+        string getString() {
+            int size = get<int>();
+            need(size);
+            string s(trace.begin() + pos, trace.begin() + pos + size);
+            pos += size;
+            return s;
+        }
+
+        vector<string> getStrings() {
+            vector<string> s(get<int>());
+            for (unsigned i = 0; i < s.size(); i++) s[i] = getString();
+            return s;
+        }
+
+        NameFormatter getFormatter(int& first, int& num) {
+            first = get<int>();
+            std::shared_ptr<vector<string>> names = std::make_shared<vector<string>>(getStrings());
+            num = (int)names->size();
+            return [names](int i) { return (*names)[i]; };
+        }
+
+        void getModel(ModelIR& ir) {
+            ir.clear();
+            ir.setMaximisation(get<int>() != 0);
+
+            vector<double> obj   = getArray<double>();
+            vector<double> lower = getArray<double>();
+            vector<double> upper = getArray<double>();
+            vector<char>   types = getArray<char>();
+            int numCols = (int)obj.size();
+            int last;
+            for (int first = 0; first < numCols; first = last) {
+                for (last = first + 1; last < numCols && types[last] == types[first]; last++) {}
+                ir.addColumns(last - first, &obj[first], &lower[first], &upper[first], types[first]);
+            }
+
+            vector<double> rhs    = getArray<double>();
+            vector<char>   sense  = getArray<char>();
+            vector<int>    rowBeg = getArray<int>();
+            vector<int>    rowInd = getArray<int>();
+            vector<double> rowVal = getArray<double>();
+            for (unsigned r = 0; r < rhs.size(); r++) {
+                int end = r + 1 < rhs.size() ? rowBeg[r+1] : (int)rowInd.size();
+                ir.addRow(end - rowBeg[r], rowInd.data() + rowBeg[r], rowVal.data() + rowBeg[r], rhs[r], sense[r]);
+            }
+
+            vector<int>    namedCols = getArray<int>();
+            vector<string> colNames  = getStrings();
+            for (unsigned i = 0; i < namedCols.size(); i++) ir.addColName(namedCols[i], colNames[i]);
+            vector<int>    namedRows = getArray<int>();
+            vector<string> rowNames  = getStrings();
+            for (unsigned i = 0; i < namedRows.size(); i++) ir.addRowName(namedRows[i], rowNames[i]);
+
+            int first, num;
+            int numColBlocks = get<int>();
+            for (int b = 0; b < numColBlocks; b++) {
+                NameFormatter format = getFormatter(first, num);
+                ir.addColFormatter(first, num, format);
+            }
+            int numRowBlocks = get<int>();
+            for (int b = 0; b < numRowBlocks; b++) {
+                NameFormatter format = getFormatter(first, num);
+                ir.addRowFormatter(first, num, format);
+            }
+        }
+};
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+// Names are kept lazily, as in IRSolver, unless enabled by the model
+RecordingSolver::RecordingSolver(Solver* targetSolver) : Solver() {
+    target   = targetSolver;
+    relaxed  = false;
+    useNames = false;
+    for (int op = 0; op < TRACE_NUM_OPS; op++) calls[op] = 0;
+
+    trace.insert(trace.end(), TRACE_MAGIC, TRACE_MAGIC + strlen(TRACE_MAGIC));
+    put((int)TRACE_VERSION);
+}
+
+RecordingSolver::~RecordingSolver() {
+    if (!traceFile.empty()) writeTrace(traceFile);
+    delete(target);
+}
+
+void RecordingSolver::writeTrace(const string& filename) {
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    if (!file) Util::throwInvalidArgument("Error: Could not open trace file %s for writing.", filename.c_str());
+    file.write(trace.data(), trace.size());
+}
+
+void RecordingSolver::printStatistics() {
+    printf("Trace: %lu bytes, %d columns, %d rows\n", (unsigned long)trace.size(), getNumCols(), getNumRows());
+    for (int op = 0; op < TRACE_NUM_OPS; op++) {
+        if (calls[op] > 0) printf("   %-26s %10d calls\n", traceOpNames[op], calls[op]);
+    }
+}
+
+void RecordingSolver::recordCuts(const CutBuffer& cuts, int first) {
+    std::lock_guard<std::mutex> guard(cutLock);
+    for (int i = first; i < cuts.getNumCuts(); i++) solveCuts.addCut(cuts, i);
+}
+
+void RecordingSolver::printSolverName() {
+    if (target) {
+        printf("Calls are recorded, ");
+        target->printSolverName();
+    } else {
+        printf("Recording solver assigned (nothing is solved)\n");
+    }
+}
+
+void RecordingSolver::deleteAndRecreateProblem() {
+    putOp(TRACE_DELETE_PROBLEM);
+    shadow.clear();
+    clearKeys();
+    relaxed = false;
+    if (target) target->deleteAndRecreateProblem();
+}
+
+int RecordingSolver::isMIP() {
+    if (target) return target->isMIP();
+    return !relaxed && shadow.isMIP();
+}
+
+/**
+ * ENCODING
+ *
+ */
+
+void RecordingSolver::putOp(TraceOp op) {
+    trace.push_back((char)op);
+    calls[op]++;
+}
+
+void RecordingSolver::putString(const string& s) {
+    put((int)s.size());
+    trace.insert(trace.end(), s.begin(), s.end());
+}
+
+void RecordingSolver::putStrings(const vector<string>& s) {
+    put((int)s.size());
+    for (const string& str : s) putString(str);
+}
+
+// Formatters cannot be stored, the names they generate are
+void RecordingSolver::putFormatter(int first, int num, const NameFormatter& format) {
+    put(first);
+    put(num);
+    for (int i = 0; i < num; i++) putString(format(i));
+}
+
+void RecordingSolver::putModel(const ModelIR& ir) {
+    int numCols = ir.getNumCols();
+    int numRows = ir.getNumRows();
+    put((int)ir.isMaximisation());
+    putArray(ir.getObj(),   numCols);
+    putArray(ir.getLower(), numCols);
+    putArray(ir.getUpper(), numCols);
+    putArray(ir.getTypes(), numCols);
+    putArray(ir.getRhs(),    numRows);
+    putArray(ir.getSense(),  numRows);
+    putArray(ir.getRowBeg(), numRows);
+    putArray(ir.getRowInd(), ir.getNumNonZeros());
+    putArray(ir.getRowVal(), ir.getNumNonZeros());
+    putArray(ir.getNamedCols().data(), (int)ir.getNamedCols().size());
+    putStrings(ir.getColNames());
+    putArray(ir.getNamedRows().data(), (int)ir.getNamedRows().size());
+    putStrings(ir.getRowNames());
+    put((int)ir.getColFormatters().size());
+    for (const NameFormatterBlock& block : ir.getColFormatters()) putFormatter(block.first, block.num, block.format);
+    put((int)ir.getRowFormatters().size());
+    for (const NameFormatterBlock& block : ir.getRowFormatters()) putFormatter(block.first, block.num, block.format);
+}
+
+/**
+ * BUILD
+ *
+ */
+
+void RecordingSolver::beginBuild(size_t maxBytes) {
+    putOp(TRACE_BEGIN_BUILD);
+    put((unsigned long long)maxBytes);
+    if (target) target->beginBuild(maxBytes);
+}
+
+void RecordingSolver::endBuild() {
+    putOp(TRACE_END_BUILD);
+    if (target) target->endBuild();
+}
+
+void RecordingSolver::loadModel(const ModelIR& ir) {
+    if (getNumCols() > 0 || getNumRows() > 0) Util::throwInvalidArgument("Error: A model can only be loaded into an empty problem.");
+    putOp(TRACE_LOAD_MODEL);
+    putModel(ir);
+    shadow = ir;
+    loadNames(ir);
+    if (target) target->loadModel(ir);
+}
+
+/**
+ * NAMES
+ *
+ */
+
+void RecordingSolver::setColNames(int firstCol, int numCols, NameFormatter format) {
+    if (numCols <= 0) return;
+    putOp(TRACE_SET_COL_NAMES);
+    putFormatter(firstCol, numCols, format);
+    Solver::setColNames(firstCol, numCols, format);
+    shadow.addColFormatter(firstCol, numCols, format);
+    if (target) target->setColNames(firstCol, numCols, format);
+}
+
+void RecordingSolver::setRowNames(int firstRow, int numRows, NameFormatter format) {
+    if (numRows <= 0) return;
+    putOp(TRACE_SET_ROW_NAMES);
+    putFormatter(firstRow, numRows, format);
+    Solver::setRowNames(firstRow, numRows, format);
+    shadow.addRowFormatter(firstRow, numRows, format);
+    if (target) target->setRowNames(firstRow, numRows, format);
+}
+
+void RecordingSolver::addColName(int col, const string& name) {
+    if (name.empty()) return;
+    addKey(name, col);
+    shadow.addColName(col, name);
+}
+
+// Names generated by the add*Variables functions, the target generates its own
+void RecordingSolver::addColNames(int firstCol, int numCols, const string& name) {
+    if (name.empty()) return;
+    NameFormatter format = [name](int i) { return name + lex(i); };
+    Solver::setColNames(firstCol, numCols, format);
+    shadow.addColFormatter(firstCol, numCols, format);
+}
+
+vector<int> RecordingSolver::getColIndices(const vector<string>& colNames) {
+    vector<int> colIndices(colNames.size());
+    for (unsigned i = 0; i < colNames.size(); i++) {
+        colIndices[i] = getColIndex(colNames[i]);
+        if (colIndices[i] == -1) Util::throwInvalidArgument("Error: Column %s was not found.", colNames[i].c_str());
+    }
+    return colIndices;
+}
+
+/**
+ * SET DATA
+ *
+ */
+
+void RecordingSolver::changeObjectiveSense(bool isMax) {
+    putOp(TRACE_OBJECTIVE_SENSE);
+    put((int)isMax);
+    shadow.setMaximisation(isMax);
+    if (target) target->changeObjectiveSense(isMax);
+}
+
+int RecordingSolver::addColumns(int numCols, const double* obj, double lower, double upper, char type) {
+    int firstCol = getNumCols();
+    vector<double> lo(numCols, lower);
+    vector<double> up(numCols, upper);
+    shadow.addColumns(numCols, obj, lo.data(), up.data(), type);
+    return firstCol;
+}
+
+int RecordingSolver::addVariable(const double lower, const double upper, const double obj, string name) {
+    putOp(TRACE_ADD_VARIABLE);
+    put(lower);
+    put(upper);
+    put(obj);
+    putString(name);
+    int col = addColumns(1, &obj, lower, upper, 'C');
+    addColName(col, name);
+    if (target) target->addVariable(lower, upper, obj, name);
+    return col;
+}
+
+int RecordingSolver::addVariables(int numCols, const double lower, const double upper, const double* obj, string& name) {
+    putOp(TRACE_ADD_VARIABLES);
+    put(lower);
+    put(upper);
+    putArray(obj, numCols);
+    putString(name);
+    int firstCol = addColumns(numCols, obj, lower, upper, 'C');
+    addColNames(firstCol, numCols, name);
+    if (target) target->addVariables(numCols, lower, upper, obj, name);
+    return firstCol;
+}
+
+int RecordingSolver::addBinaryVariable(const double obj, string name) {
+    putOp(TRACE_ADD_BINARY_VARIABLE);
+    put(obj);
+    putString(name);
+    int col = addColumns(1, &obj, 0.0, 1.0, 'B');
+    addColName(col, name);
+    if (target) target->addBinaryVariable(obj, name);
+    return col;
+}
+
+int RecordingSolver::addBinaryVariables(int numCols, const double* obj, string& name) {
+    putOp(TRACE_ADD_BINARY_VARIABLES);
+    putArray(obj, numCols);
+    putString(name);
+    int firstCol = addColumns(numCols, obj, 0.0, 1.0, 'B');
+    addColNames(firstCol, numCols, name);
+    if (target) target->addBinaryVariables(numCols, obj, name);
+    return firstCol;
+}
+
+int RecordingSolver::addIntegerVariable(const double lower, const double upper, const double obj, string name) {
+    putOp(TRACE_ADD_INTEGER_VARIABLE);
+    put(lower);
+    put(upper);
+    put(obj);
+    putString(name);
+    int col = addColumns(1, &obj, lower, upper, 'I');
+    addColName(col, name);
+    if (target) target->addIntegerVariable(lower, upper, obj, name);
+    return col;
+}
+
+int RecordingSolver::addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name) {
+    putOp(TRACE_ADD_INTEGER_VARIABLES);
+    put(lb);
+    put(ub);
+    putArray(obj, numCols);
+    putString(name);
+    int firstCol = addColumns(numCols, obj, lb, ub, 'I');
+    addColNames(firstCol, numCols, name);
+    if (target) target->addIntegerVariables(numCols, lb, ub, obj, name);
+    return firstCol;
+}
+
+// Recorded with the names, so that replaying it measures the lookups of the target
+void RecordingSolver::addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
+    vector<int> colIndices = getColIndices(colNames);
+    if (sense != 'L' && sense != 'E' && sense != 'G')
+        Util::throwInvalidArgument("Error: In addRow, invalid sense %c (valid values are 'L', 'E' and 'G').", sense);
+
+    putOp(TRACE_ADD_ROW_BY_NAME);
+    putStrings(colNames);
+    putArray(elements.data(), (int)elements.size());
+    put(rhs);
+    put(sense);
+    putString(name);
+    if (!name.empty()) shadow.addRowName(getNumRows(), name);
+    shadow.addRow((int)colIndices.size(), colIndices.data(), elements.data(), rhs, sense);
+    if (target) target->addRow(colNames, elements, rhs, sense, name);
+}
+
+void RecordingSolver::addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    if (sense != 'L' && sense != 'E' && sense != 'G')
+        Util::throwInvalidArgument("Error: In addRow, invalid sense %c (valid values are 'L', 'E' and 'G').", sense);
+
+    putOp(TRACE_ADD_ROW);
+    putArray(colIndices, numNonZero);
+    putArray(elements, numNonZero);
+    put(rhs);
+    put(sense);
+    putString(name);
+    if (!name.empty()) shadow.addRowName(getNumRows(), name);
+    shadow.addRow(numNonZero, colIndices, elements, rhs, sense);
+    if (target) target->addRow(numNonZero, colIndices, elements, rhs, sense, name);
+}
+
+void RecordingSolver::addLazyConstraint(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
+    vector<int> colIndices = getColIndices(colNames);
+    addLazyConstraint((int)colIndices.size(), colIndices.data(), elements.data(), rhs, sense, name);
+}
+
+// Lazy constraints and user cuts are not part of the shadow model
+void RecordingSolver::addLazyConstraint(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    putOp(TRACE_ADD_LAZY_CONSTRAINT);
+    putArray(colIndices, numNonZero);
+    putArray(elements, numNonZero);
+    put(rhs);
+    put(sense);
+    putString(name);
+    if (target) target->addLazyConstraint(numNonZero, colIndices, elements, rhs, sense, name);
+}
+
+void RecordingSolver::addUserCut(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
+    vector<int> colIndices = getColIndices(colNames);
+    addUserCut((int)colIndices.size(), colIndices.data(), elements.data(), rhs, sense, name);
+}
+
+void RecordingSolver::addUserCut(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    putOp(TRACE_ADD_USER_CUT);
+    putArray(colIndices, numNonZero);
+    putArray(elements, numNonZero);
+    put(rhs);
+    put(sense);
+    putString(name);
+    if (target) target->addUserCut(numNonZero, colIndices, elements, rhs, sense, name);
+}
+
+void RecordingSolver::setColBounds(int col, double lower, double upper) {
+    putOp(TRACE_SET_COL_BOUNDS);
+    put(col);
+    put(lower);
+    put(upper);
+    shadow.setBounds(col, lower, upper);
+    if (target) target->setColBounds(col, lower, upper);
+}
+
+void RecordingSolver::setPriorityInBranching(vector<string> colNames, int priority) {
+    setPriorityInBranching(colNames, vector<int>(colNames.size(), priority));
+}
+
+void RecordingSolver::setPriorityInBranching(vector<string> colNames, vector<int> priorities) {
+    putOp(TRACE_PRIORITY);
+    putStrings(colNames);
+    putArray(priorities.data(), (int)priorities.size());
+    if (target) target->setPriorityInBranching(colNames, priorities);
+}
+
+void RecordingSolver::setVariablesWarmStart(vector<string> colNames, vector<double> values) {
+    putOp(TRACE_WARM_START);
+    putStrings(colNames);
+    putArray(values.data(), (int)values.size());
+    if (target) target->setVariablesWarmStart(colNames, values);
+}
+
+void RecordingSolver::setVariableWarmStart(string colName, double value) {
+    setVariablesWarmStart(vector<string>(1, colName), vector<double>(1, value));
+}
+
+void RecordingSolver::refineMIPStart() {
+    putOp(TRACE_REFINE_MIP_START);
+    if (target) target->refineMIPStart();
+}
+
+void RecordingSolver::relax() {
+    putOp(TRACE_RELAX);
+    relaxed = true;
+    if (target) target->relax();
+}
+
+/**
+ * SOLVE
+ *
+ */
+
+void RecordingSolver::doSolve() {
+    size_t solvePos = trace.size();
+    putOp(TRACE_SOLVE);
+    solveCuts.clear();
+    if (target) target->solve();
+
+    // The cuts are only known now, they are moved in front of the solve
+    size_t cutsPos = trace.size();
+    for (int i = 0; i < solveCuts.getNumCuts(); i++) {
+        int beg = solveCuts.getBegin(i);
+        int num = solveCuts.getEnd(i) - beg;
+        putOp(TRACE_CALLBACK_CUT);
+        putArray(solveCuts.getRowInd() + beg, num);
+        putArray(solveCuts.getRowVal() + beg, num);
+        put(solveCuts.getRhs()[i]);
+        put(solveCuts.getSense()[i]);
+    }
+    std::rotate(trace.begin() + solvePos, trace.begin() + cutsPos, trace.end());
+    solveCuts.clear();
+}
+
+// Without a target the solution is all zeros
+void RecordingSolver::getColSolution() {
+    putOp(TRACE_GET_SOLUTION);
+    if (!target) {
+        colSolution.assign(getNumCols(), 0.0);
+        return;
+    }
+    target->getColSolution();
+    const double* values = target->getColValues();
+    colSolution.assign(values, values + getNumCols());
+}
+
+/**
+ * PARAMS
+ *
+ */
+
+void RecordingSolver::setTimeLimit(double time) {
+    putOp(TRACE_TIME_LIMIT);
+    put(time);
+    if (target) target->setTimeLimit(time);
+}
+
+void RecordingSolver::setNodeLimit(int lim) {
+    putOp(TRACE_NODE_LIMIT);
+    put(lim);
+    if (target) target->setNodeLimit(lim);
+}
+
+void RecordingSolver::enablePresolve(bool enable) {
+    putOp(TRACE_PRESOLVE);
+    put((int)enable);
+    if (target) target->enablePresolve(enable);
+}
+
+void RecordingSolver::setLPMethod(int lp) {
+    putOp(TRACE_LP_METHOD);
+    put(lp);
+    if (target) target->setLPMethod(lp);
+}
+
+void RecordingSolver::setFeasibilityPump(int fp) {
+    putOp(TRACE_FEASIBILITY_PUMP);
+    put(fp);
+    if (target) target->setFeasibilityPump(fp);
+}
+
+void RecordingSolver::setSolverRandomSeed(int seed) {
+    putOp(TRACE_RANDOM_SEED);
+    put(seed);
+    if (target) target->setSolverRandomSeed(seed);
+}
+
+void RecordingSolver::setSolverCuts(int solverCuts, int clique, int cover, int disj, int landp, int flowcover, int flowpath,
+                                    int gomory, int gub, int implbd, int mir, int mcf, int zerohalf) {
+    int values[] = {solverCuts, clique, cover, disj, landp, flowcover, flowpath, gomory, gub, implbd, mir, mcf, zerohalf};
+    putOp(TRACE_SOLVER_CUTS);
+    putArray(values, 13);
+    if (target) target->setSolverCuts(solverCuts, clique, cover, disj, landp, flowcover, flowpath, gomory, gub, implbd, mir, mcf, zerohalf);
+}
+
+void RecordingSolver::setMIPEmphasis(int t) {
+    putOp(TRACE_MIP_EMPHASIS);
+    put(t);
+    if (target) target->setMIPEmphasis(t);
+}
+
+void RecordingSolver::setMIPStrategy(int t) {
+    putOp(TRACE_MIP_STRATEGY);
+    put(t);
+    if (target) target->setMIPStrategy(t);
+}
+
+void RecordingSolver::setSolverParallelism(int t, int m) {
+    putOp(TRACE_PARALLELISM);
+    put(t);
+    put(m);
+    if (target) target->setSolverParallelism(t, m);
+}
+
+void RecordingSolver::setSolverLocalBranching(int t) {
+    putOp(TRACE_LOCAL_BRANCHING);
+    put(t);
+    if (target) target->setSolverLocalBranching(t);
+}
+
+void RecordingSolver::setNodeHeuristic(int t) {
+    putOp(TRACE_NODE_HEURISTIC);
+    put(t);
+    if (target) target->setNodeHeuristic(t);
+}
+
+void RecordingSolver::setProbingLevel(int t) {
+    putOp(TRACE_PROBING_LEVEL);
+    put(t);
+    if (target) target->setProbingLevel(t);
+}
+
+/**
+ * CALLBACKS
+ *
+ */
+
+void RecordingSolver::addLazyCallback(void* userData) {
+    putOp(TRACE_CALLBACK);
+    put((int)TRACE_LAZY_CALLBACK);
+    if (target) target->addLazyCallback(userData);
+}
+
+void RecordingSolver::addUserCutCallback(void* userData) {
+    putOp(TRACE_CALLBACK);
+    put((int)TRACE_USER_CUT_CALLBACK);
+    if (target) target->addUserCutCallback(userData);
+}
+
+void RecordingSolver::addIncumbentCallback(void* userData) {
+    putOp(TRACE_CALLBACK);
+    put((int)TRACE_INCUMBENT_CALLBACK);
+    if (target) target->addIncumbentCallback(userData);
+}
+
+void RecordingSolver::addInfoCallback(void* userData) {
+    putOp(TRACE_CALLBACK);
+    put((int)TRACE_INFO_CALLBACK);
+    if (target) target->addInfoCallback(userData);
+}
+
+void RecordingSolver::addNodeCallback(void* userData) {
+    putOp(TRACE_CALLBACK);
+    put((int)TRACE_NODE_CALLBACK);
+    if (target) target->addNodeCallback(userData);
+}
+
+void RecordingSolver::addSolveCallback(void* userData) {
+    putOp(TRACE_CALLBACK);
+    put((int)TRACE_SOLVE_CALLBACK);
+    if (target) target->addSolveCallback(userData);
+}
+
+void RecordingSolver::setListener(SolverListener* l) {
+    Solver::setListener(l);
+    if (target) target->setListener(l ? this : NULL);
+}
+
+/**
+ * REPLAY
+ *
+ */
+
+int RecordingSolver::replay(const string& filename, Solver* solver, int debug) {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if (!file) Util::throwInvalidArgument("Error: Could not open trace file %s.", filename.c_str());
+    vector<char> trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return replay(trace, solver, debug);
+}
+
+/**
+ * Calls solver as recorded. With debug > 0 the time spent in the solver is printed per function.
+ */
+int RecordingSolver::replay(const vector<char>& trace, Solver* solver, int debug) {
+    size_t magicSize = strlen(TRACE_MAGIC);
+    if (trace.size() < magicSize || memcmp(trace.data(), TRACE_MAGIC, magicSize) != 0)
+        Util::throwInvalidArgument("Error: Not a trace file.");
+
+    vector<char> body(trace.begin() + magicSize, trace.end());
+    TraceReader in(body);
+    int version = in.get<int>();
+    if (version != TRACE_VERSION) Util::throwInvalidArgument("Error: Trace version %d is not supported (expected %d).", version, TRACE_VERSION);
+
+    int    count[TRACE_NUM_OPS] = {0};
+    double time [TRACE_NUM_OPS] = {0};
+    int numCalls = 0;
+    bool warned  = false;
+    ModelIR ir;
+
+    while (!in.atEnd()) {
+        int op = (unsigned char)in.get<char>();
+        if (op >= TRACE_NUM_OPS) Util::throwInvalidArgument("Error: Invalid op code %d in trace.", op);
+
+        // Arguments are decoded before the clock starts
+        double d1 = 0, d2 = 0, d3 = 0;
+        int    i1 = 0, i2 = 0;
+        char   c1 = 0;
+        string name;
+        vector<int>    ints;
+        vector<double> doubles;
+        vector<string> strings;
+        NameFormatter  format;
+        switch (op) {
+            case TRACE_OBJECTIVE_SENSE:
+            case TRACE_NODE_LIMIT:
+            case TRACE_PRESOLVE:
+            case TRACE_LP_METHOD:
+            case TRACE_FEASIBILITY_PUMP:
+            case TRACE_RANDOM_SEED:
+            case TRACE_MIP_EMPHASIS:
+            case TRACE_MIP_STRATEGY:
+            case TRACE_LOCAL_BRANCHING:
+            case TRACE_NODE_HEURISTIC:
+            case TRACE_PROBING_LEVEL:
+            case TRACE_CALLBACK:
+                i1 = in.get<int>();
+                break;
+            case TRACE_PARALLELISM:
+                i1 = in.get<int>();
+                i2 = in.get<int>();
+                break;
+            case TRACE_TIME_LIMIT:
+                d1 = in.get<double>();
+                break;
+            case TRACE_BEGIN_BUILD:
+                d1 = (double)in.get<unsigned long long>();
+                break;
+            case TRACE_ADD_VARIABLE:
+            case TRACE_ADD_INTEGER_VARIABLE:
+                d1 = in.get<double>();
+                d2 = in.get<double>();
+                d3 = in.get<double>();
+                name = in.getString();
+                break;
+            case TRACE_ADD_BINARY_VARIABLE:
+                d3 = in.get<double>();
+                name = in.getString();
+                break;
+            case TRACE_ADD_VARIABLES:
+            case TRACE_ADD_INTEGER_VARIABLES:
+                d1 = in.get<double>();
+                d2 = in.get<double>();
+                doubles = in.getArray<double>();
+                name = in.getString();
+                break;
+            case TRACE_ADD_BINARY_VARIABLES:
+                doubles = in.getArray<double>();
+                name = in.getString();
+                break;
+            case TRACE_ADD_ROW_BY_NAME:
+                strings = in.getStrings();
+                doubles = in.getArray<double>();
+                d1   = in.get<double>();
+                c1   = in.get<char>();
+                name = in.getString();
+                break;
+            case TRACE_ADD_ROW:
+            case TRACE_ADD_LAZY_CONSTRAINT:
+            case TRACE_ADD_USER_CUT:
+                ints    = in.getArray<int>();
+                doubles = in.getArray<double>();
+                d1   = in.get<double>();
+                c1   = in.get<char>();
+                name = in.getString();
+                break;
+            case TRACE_CALLBACK_CUT:
+                ints    = in.getArray<int>();
+                doubles = in.getArray<double>();
+                d1 = in.get<double>();
+                c1 = in.get<char>();
+                break;
+            case TRACE_SET_COL_BOUNDS:
+                i1 = in.get<int>();
+                d1 = in.get<double>();
+                d2 = in.get<double>();
+                break;
+            case TRACE_SET_COL_NAMES:
+            case TRACE_SET_ROW_NAMES:
+                format = in.getFormatter(i1, i2);
+                break;
+            case TRACE_LOAD_MODEL:
+                in.getModel(ir);
+                break;
+            case TRACE_PRIORITY:
+                strings = in.getStrings();
+                ints    = in.getArray<int>();
+                break;
+            case TRACE_WARM_START:
+                strings = in.getStrings();
+                doubles = in.getArray<double>();
+                break;
+            case TRACE_SOLVER_CUTS:
+                ints = in.getArray<int>();
+                if (ints.size() != 13) Util::throwInvalidArgument("Error: Invalid setSolverCuts record in trace.");
+                break;
+            default:
+                break;
+        }
+
+        if (op == TRACE_CALLBACK && !warned) {
+            printf("Warning: The trace registered callbacks, which are not replayed. The cuts they returned are added as rows "
+                   "before each solve, the replayed solves may still differ from the recorded ones.\n");
+            warned = true;
+        }
+
+        double start = Util::getWallTime();
+        switch (op) {
+            case TRACE_DELETE_PROBLEM:        solver->deleteAndRecreateProblem();                                           break;
+            case TRACE_OBJECTIVE_SENSE:       solver->changeObjectiveSense(i1 != 0);                                        break;
+            case TRACE_ADD_VARIABLE:          solver->addVariable(d1, d2, d3, name);                                        break;
+            case TRACE_ADD_VARIABLES:         solver->addVariables((int)doubles.size(), d1, d2, doubles.data(), name);      break;
+            case TRACE_ADD_BINARY_VARIABLE:   solver->addBinaryVariable(d3, name);                                          break;
+            case TRACE_ADD_BINARY_VARIABLES:  solver->addBinaryVariables((int)doubles.size(), doubles.data(), name);        break;
+            case TRACE_ADD_INTEGER_VARIABLE:  solver->addIntegerVariable(d1, d2, d3, name);                                 break;
+            case TRACE_ADD_INTEGER_VARIABLES: solver->addIntegerVariables((int)doubles.size(), d1, d2, doubles.data(), name); break;
+            case TRACE_ADD_ROW_BY_NAME:       solver->addRow(strings, doubles, d1, c1, name);                               break;
+            case TRACE_ADD_ROW:               solver->addRow((int)ints.size(), ints.data(), doubles.data(), d1, c1, name);  break;
+            case TRACE_ADD_LAZY_CONSTRAINT:   solver->addLazyConstraint((int)ints.size(), ints.data(), doubles.data(), d1, c1, name); break;
+            case TRACE_ADD_USER_CUT:          solver->addUserCut((int)ints.size(), ints.data(), doubles.data(), d1, c1, name); break;
+            case TRACE_SET_COL_BOUNDS:        solver->setColBounds(i1, d1, d2);                                             break;
+            case TRACE_SET_COL_NAMES:         solver->setColNames(i1, i2, format);                                          break;
+            case TRACE_SET_ROW_NAMES:         solver->setRowNames(i1, i2, format);                                          break;
+            case TRACE_BEGIN_BUILD:           solver->beginBuild((size_t)d1);                                               break;
+            case TRACE_END_BUILD:             solver->endBuild();                                                           break;
+            case TRACE_LOAD_MODEL:            solver->loadModel(ir);                                                        break;
+            case TRACE_PRIORITY:              solver->setPriorityInBranching(strings, ints);                                break;
+            case TRACE_WARM_START:            solver->setVariablesWarmStart(strings, doubles);                              break;
+            case TRACE_REFINE_MIP_START:      solver->refineMIPStart();                                                     break;
+            case TRACE_RELAX:                 solver->relax();                                                              break;
+            case TRACE_SOLVE:                 solver->solve();                                                              break;
+            case TRACE_GET_SOLUTION:          solver->getColSolution();                                                     break;
+            case TRACE_TIME_LIMIT:            solver->setTimeLimit(d1);                                                     break;
+            case TRACE_NODE_LIMIT:            solver->setNodeLimit(i1);                                                     break;
+            case TRACE_PRESOLVE:              solver->enablePresolve(i1 != 0);                                              break;
+            case TRACE_LP_METHOD:             solver->setLPMethod(i1);                                                      break;
+            case TRACE_FEASIBILITY_PUMP:      solver->setFeasibilityPump(i1);                                               break;
+            case TRACE_RANDOM_SEED:           solver->setSolverRandomSeed(i1);                                              break;
+            case TRACE_SOLVER_CUTS:           solver->setSolverCuts(ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6],
+                                                                    ints[7], ints[8], ints[9], ints[10], ints[11], ints[12]);   break;
+            case TRACE_MIP_EMPHASIS:          solver->setMIPEmphasis(i1);                                                   break;
+            case TRACE_MIP_STRATEGY:          solver->setMIPStrategy(i1);                                                   break;
+            case TRACE_PARALLELISM:           solver->setSolverParallelism(i1, i2);                                         break;
+            case TRACE_LOCAL_BRANCHING:       solver->setSolverLocalBranching(i1);                                          break;
+            case TRACE_NODE_HEURISTIC:        solver->setNodeHeuristic(i1);                                                 break;
+            case TRACE_PROBING_LEVEL:         solver->setProbingLevel(i1);                                                  break;
+            case TRACE_CALLBACK:                                                                                            break;
+            case TRACE_CALLBACK_CUT:          solver->addRow((int)ints.size(), ints.data(), doubles.data(), d1, c1);        break;
+        }
+        time[op] += Util::getWallTime() - start;
+        count[op]++;
+        numCalls++;
+    }
+
+    if (debug) {
+        printf("Trace replayed, %d calls\n", numCalls);
+        for (int op = 0; op < TRACE_NUM_OPS; op++) {
+            if (count[op] > 0) printf("   %-26s %10d calls %10.3fs\n", traceOpNames[op], count[op], time[op]);
+        }
+    }
+    return numCalls;
+}
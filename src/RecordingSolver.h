@@ -0,0 +1,231 @@
+/**
+ * RecordingSolver.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef RECORDINGSOLVER_H
+#define RECORDINGSOLVER_H
+
+#include "Solver.h"
+#include "CutBuffer.h"
+#include <mutex>
+
+enum TraceOp {
+    TRACE_DELETE_PROBLEM = 0,
+    TRACE_OBJECTIVE_SENSE,
+    TRACE_ADD_VARIABLE,
+    TRACE_ADD_VARIABLES,
+    TRACE_ADD_BINARY_VARIABLE,
+    TRACE_ADD_BINARY_VARIABLES,
+    TRACE_ADD_INTEGER_VARIABLE,
+    TRACE_ADD_INTEGER_VARIABLES,
+    TRACE_ADD_ROW_BY_NAME,
+    TRACE_ADD_ROW,
+    TRACE_ADD_LAZY_CONSTRAINT,
+    TRACE_ADD_USER_CUT,
+    TRACE_SET_COL_BOUNDS,
+    TRACE_SET_COL_NAMES,
+    TRACE_SET_ROW_NAMES,
+    TRACE_BEGIN_BUILD,
+    TRACE_END_BUILD,
+    TRACE_LOAD_MODEL,
+    TRACE_PRIORITY,
+    TRACE_WARM_START,
+    TRACE_REFINE_MIP_START,
+    TRACE_RELAX,
+    TRACE_SOLVE,
+    TRACE_GET_SOLUTION,
+    TRACE_TIME_LIMIT,
+    TRACE_NODE_LIMIT,
+    TRACE_PRESOLVE,
+    TRACE_LP_METHOD,
+    TRACE_FEASIBILITY_PUMP,
+    TRACE_RANDOM_SEED,
+    TRACE_SOLVER_CUTS,
+    TRACE_MIP_EMPHASIS,
+    TRACE_MIP_STRATEGY,
+    TRACE_PARALLELISM,
+    TRACE_LOCAL_BRANCHING,
+    TRACE_NODE_HEURISTIC,
+    TRACE_PROBING_LEVEL,
+    TRACE_CALLBACK,
+    TRACE_CALLBACK_CUT,
+    TRACE_NUM_OPS
+};
+
+/**
+ * Solver that records every call into a compact binary trace and keeps a shadow of the model.
+ *
+ * If a target solver is given calls are also passed on to it (and the recorder takes ownership of
+ * it), otherwise nothing is solved, which allows measuring model construction and solution reading
+ * without a real backend. A trace can be replayed into any solver.
+ *
+ * Callbacks cannot be replayed, as user data cannot be stored. Their registrations are recorded, and
+ * the cuts they returned during a solve (given by the model through recordCuts) are recorded right
+ * before it, to be replayed as rows. A replayed solve may still differ from the recorded one, as it
+ * only sees the cuts separated then. Cutoffs, termination requests and listeners are passed on but
+ * not recorded, they may come from other threads.
+ *
+ * Format: "OPTTRACE", version (int), then records made of an op code (one byte) and its arguments.
+ * Arrays and strings are stored as their size (int) followed by the elements.
+ */
+class RecordingSolver : public Solver, public SolverListener {
+
+    private:
+
+        Solver* target;
+        ModelIR shadow;
+        bool relaxed;
+        string traceFile;
+
+        vector<char> trace;
+        int calls[TRACE_NUM_OPS];
+
+        // Cuts returned by the callbacks during the current solve
+        std::mutex cutLock;
+        CutBuffer solveCuts;
+
+        template<typename T> void put(const T& value) {
+            const char* p = reinterpret_cast<const char*>(&value);
+            trace.insert(trace.end(), p, p + sizeof(T));
+        }
+        template<typename T> void putArray(const T* values, int num) {
+            put(num);
+            const char* p = reinterpret_cast<const char*>(values);
+            trace.insert(trace.end(), p, p + sizeof(T) * num);
+        }
+        void putOp(TraceOp op);
+        void putString(const string& s);
+        void putStrings(const vector<string>& s);
+        void putFormatter(int first, int num, const NameFormatter& format);
+        void putModel(const ModelIR& ir);
+
+        int addColumns(int numCols, const double* obj, double lower, double upper, char type);
+        void addColName(int col, const string& name);
+        void addColNames(int firstCol, int numCols, const string& name);
+        vector<int> getColIndices(const vector<string>& colNames);
+
+    public:
+
+        RecordingSolver(Solver* targetSolver = NULL);
+        virtual ~RecordingSolver();
+
+        // Trace
+        void setTraceFile(const string& filename) { traceFile = filename; }
+        void writeTrace(const string& filename);
+        const vector<char>& getTrace()  { return trace;  }
+        const ModelIR& getShadowModel() { return shadow; }
+        Solver* getTarget()             { return target; }
+        void printStatistics();
+        // Called by the model, from any thread, with the cuts from first on its callbacks returned
+        void recordCuts(const CutBuffer& cuts, int first);
+
+        // Replays a trace into solver, returns the number of calls replayed
+        static int replay(const string& filename, Solver* solver, int debug = 0);
+        static int replay(const vector<char>& trace, Solver* solver, int debug = 0);
+
+        virtual void deleteAndRecreateProblem();
+        virtual int isMIP();
+
+        // Build
+        virtual void beginBuild(size_t maxBytes);
+        virtual void endBuild();
+        virtual void loadModel(const ModelIR& ir);
+
+        // Names
+        virtual void setColNames(int firstCol, int numCols, NameFormatter format);
+        virtual void setRowNames(int firstRow, int numRows, NameFormatter format);
+
+        // Set data
+        virtual void changeObjectiveSense(bool isMax);
+        virtual int addVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addVariables(int numCols, const double lower, const double upper, const double* obj, string& name);
+        virtual int addBinaryVariable(const double obj, string name);
+        virtual int addBinaryVariables(int numCols, const double* obj, string& name);
+        virtual int addIntegerVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name);
+        virtual void addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
+        virtual void addLazyConstraint(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addLazyConstraint(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
+        virtual void addUserCut(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addUserCut(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
+        virtual void setColBounds(int col, double lower, double upper);
+        virtual void setPriorityInBranching(vector<string> colNames, int priority);
+        virtual void setPriorityInBranching(vector<string> colNames, vector<int> priorities);
+        virtual void setVariablesWarmStart(vector<string> colNames, vector<double> values);
+        virtual void setVariableWarmStart(string colName, double value);
+        virtual void refineMIPStart();
+        virtual void relax();
+
+        // Solve
+        virtual void doSolve();
+        virtual void setCutoff(double value) { if (target) target->setCutoff(value); }
+        virtual void terminate()             { if (target) target->terminate();      }
+        // Only affects callbacks, which are not recorded
+        virtual void setCutSelection(int budget, double maxParallelism) { if (target) target->setCutSelection(budget, maxParallelism); }
+
+        // Get data
+        virtual int getNumCols() { return shadow.getNumCols(); }
+        virtual int getNumRows() { return shadow.getNumRows(); }
+        virtual int getStatus()         { return target ? target->getStatus()    : 0; }
+        virtual double getObjValue()    { return target ? target->getObjValue()  : 0; }
+        virtual double getBestBound()   { return target ? target->getBestBound() : 0; }
+        virtual int getNodeCount()      { return target ? target->getNodeCount() : 0; }
+        virtual void getColSolution();
+
+        // Params
+        virtual void setTimeLimit(double time);
+        virtual void setNodeLimit(int lim);
+        virtual void enablePresolve(bool enable = true);
+        virtual void setLPMethod(int lp);
+        virtual void setFeasibilityPump(int fp);
+        virtual void setSolverRandomSeed(int seed);
+        virtual void setSolverCuts(int solverCuts = -2, int clique   = -2, int cover    = -2, int disj = -2, int landp  = -2,
+                                   int flowcover  = -2, int flowpath = -2, int gomory   = -2, int gub  = -2, int implbd = -2,
+                                   int mir        = -2, int mcf      = -2, int zerohalf = -2);
+        virtual void setMIPEmphasis(int t);
+        virtual void setMIPStrategy(int t);
+        virtual void setSolverParallelism(int t, int m);
+        virtual void setSolverLocalBranching(int t);
+        virtual void setNodeHeuristic(int t);
+        virtual void setProbingLevel(int t);
+
+        // Debug
+        virtual void printSolverName();
+        virtual void debugInformation(int debug)       { if (target) target->debugInformation(debug);  }
+        virtual void debugLevel(int debugLevel)        { if (target) target->debugLevel(debugLevel);   }
+        virtual void exportModel(const char* filename) { if (target) target->exportModel(filename);    }
+
+        // Status
+        virtual bool solutionExists()            { return target && target->solutionExists();           }
+        virtual bool isOptimal()                 { return target && target->isOptimal();                }
+        virtual bool isIntegerOptimal()          { return target && target->isIntegerOptimal();         }
+        virtual bool isInfeasible()              { return target && target->isInfeasible();             }
+        virtual bool isUnbounded()               { return target && target->isUnbounded();              }
+        virtual bool isInfeasibleOrUnbounded()   { return target && target->isInfeasibleOrUnbounded();  }
+        virtual bool isTimeLimit()               { return target && target->isTimeLimit();              }
+        virtual bool isMIPTimeLimitFeasible()    { return target && target->isMIPTimeLimitFeasible();   }
+        virtual bool isMIPTimeLimitInfeasible()  { return target && target->isMIPTimeLimitInfeasible(); }
+        virtual bool isIterationLimitReached()   { return target && target->isIterationLimitReached();  }
+        virtual bool isNumericalDifficulties()   { return target && target->isNumericalDifficulties();  }
+
+        // Callbacks
+        virtual void addLazyCallback     (void* userData);
+        virtual void addUserCutCallback  (void* userData);
+        virtual void addIncumbentCallback(void* userData);
+        virtual void addInfoCallback     (void* userData);
+        virtual void addNodeCallback     (void* userData);
+        virtual void addSolveCallback    (void* userData);
+        virtual void setListener(SolverListener* l);
+
+        // Progress of the target is reported as that of the recorder
+        virtual void newIncumbent(Solver* solver, double value) { if (listener) listener->newIncumbent(this, value); }
+        virtual void newBound    (Solver* solver, double bound) { if (listener) listener->newBound(this, bound);     }
+        virtual void newNodeCount(Solver* solver, int nodes)    { if (listener) listener->newNodeCount(this, nodes); }
+};
+
+#endif
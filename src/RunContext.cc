@@ -0,0 +1,48 @@
+/**
+ * RunContext.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "RunContext.h"
+#include <cstdarg>
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+RunContext* RunContext::getDefault() {
+    static RunContext context((Options*)NULL);
+    return &context;
+}
+
+RunContext::RunContext(const Options& baseOptions) {
+    options     = new Options(baseOptions);
+    ownsOptions = true;
+    output      = stdout;
+}
+
+RunContext::RunContext(Options* sharedOptions) {
+    options     = sharedOptions;
+    ownsOptions = false;
+    output      = stdout;
+}
+
+RunContext::~RunContext() {
+    if (ownsOptions) delete(options);
+}
+
+void RunContext::print(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(output, format, args);
+    va_end(args);
+}
+
+double RunContext::getCounter(const string& name) {
+    map<string, double>::iterator it = counters.find(name);
+    return it == counters.end() ? 0 : it->second;
+}
@@ -0,0 +1,58 @@
+/**
+ * RunContext.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef RUNCONTEXT_H
+#define RUNCONTEXT_H
+
+#include "Util.h"
+#include "Options.h"
+
+/**
+ * Everything a run (reading data, building and solving a model) reads or writes besides its
+ * own objects: options, where output goes and counters.
+ *
+ * Execute, Data, Model and Solution take a context, so runs with different contexts can be
+ * executed concurrently on separate threads. The default context uses the global options and
+ * standard output.
+ */
+class RunContext {
+
+    private:
+
+        Options* options;
+        bool     ownsOptions;
+        FILE*    output;
+
+        map<string, double> counters;
+
+    public:
+
+        // Context shared by everything not given one
+        static RunContext* getDefault();
+
+        // Copy of the given options (the global ones by default)
+        RunContext(const Options& baseOptions = *Options::getInstance());
+        // Uses the given options, which are not copied. NULL means the global options
+        RunContext(Options* sharedOptions);
+        ~RunContext();
+
+        Options* getOptions() { return options ? options : Options::getInstance(); }
+
+        // Output sink, standard output by default. The file is not closed by the context
+        void  setOutput(FILE* file) { output = file; }
+        FILE* getOutput()           { return output; }
+        void  print(const char* format, ...);
+
+        // Named counters, e.g. time and nodes of the run
+        void   addCounter(const string& name, double value) { counters[name] += value; }
+        void   setCounter(const string& name, double value) { counters[name]  = value; }
+        double getCounter(const string& name);
+        const map<string, double>& getCounters() { return counters; }
+};
+
+#endif
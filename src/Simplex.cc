@@ -0,0 +1,581 @@
+/**
+ * Simplex.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Simplex.h"
+
+// Bounds at or beyond this value are infinite
+#define SIMPLEX_INFINITY         1e20
+#define SIMPLEX_PRIMAL_TOLERANCE 1e-7
+#define SIMPLEX_DUAL_TOLERANCE   1e-7
+#define SIMPLEX_PIVOT_TOLERANCE  1e-7
+// Updates before the basis is factorised again
+#define SIMPLEX_REFACTOR         64
+// Consecutive degenerate pivots before switching to Bland's rule
+#define SIMPLEX_MAX_DEGENERATE   50
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+Simplex::Simplex() : Solver() {
+    relaxed    = false;
+    timeLimit  = 0;
+    debug      = 0;
+    n          = 0;
+    m          = 0;
+    objValue   = 0;
+    iterations = 0;
+    iterationLimit = 0;
+    maxIterations  = 0;
+    startTime  = 0;
+}
+
+Simplex::~Simplex() {
+}
+
+void Simplex::deleteAndRecreateProblem() {
+    lp.clear();
+    clearKeys();
+    head.clear();
+    colBeg.clear();
+    n = 0;
+    m = 0;
+    relaxed  = false;
+    status   = SIMPLEX_UNSOLVED;
+    objValue = 0;
+}
+
+int Simplex::isMIP() {
+    return !relaxed && lp.isMIP();
+}
+
+void Simplex::printSolverName() {
+    printf("Solver used is the built-in simplex\n");
+}
+
+/**
+ * SET DATA
+ *
+ */
+
+void Simplex::changeObjectiveSense(bool isMax) {
+    lp.setMaximisation(isMax);
+}
+
+int Simplex::addVariable(const double lower, const double upper, const double obj, string name) {
+    int col = getNumCols();
+    lp.addColumns(1, &obj, &lower, &upper, 'C');
+    if (!name.empty()) addKey(name, col);
+    return col;
+}
+
+int Simplex::addVariables(int numCols, const double lower, const double upper, const double* obj, string& name) {
+    int firstCol = getNumCols();
+    vector<double> lo(numCols, lower);
+    vector<double> up(numCols, upper);
+    lp.addColumns(numCols, obj, &lo[0], &up[0], 'C');
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
+
+int Simplex::addBinaryVariable(const double obj, string name) {
+    int col = getNumCols();
+    double lower = 0.0;
+    double upper = 1.0;
+    lp.addColumns(1, &obj, &lower, &upper, 'B');
+    if (!name.empty()) addKey(name, col);
+    return col;
+}
+
+int Simplex::addBinaryVariables(int numCols, const double* obj, string& name) {
+    int firstCol = getNumCols();
+    vector<double> lo(numCols, 0.0);
+    vector<double> up(numCols, 1.0);
+    lp.addColumns(numCols, obj, &lo[0], &up[0], 'B');
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
+
+int Simplex::addIntegerVariable(const double lower, const double upper, const double obj, string name) {
+    int col = getNumCols();
+    lp.addColumns(1, &obj, &lower, &upper, 'I');
+    if (!name.empty()) addKey(name, col);
+    return col;
+}
+
+int Simplex::addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name) {
+    int firstCol = getNumCols();
+    vector<double> lo(numCols, lb);
+    vector<double> up(numCols, ub);
+    lp.addColumns(numCols, obj, &lo[0], &up[0], 'I');
+    if (!name.empty()) setColNames(firstCol, numCols, [name](int i) { return name + lex(i); });
+    return firstCol;
+}
+
+void Simplex::addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name) {
+    int numNonZero = (int)colNames.size();
+
+    vector<int> colIndices(numNonZero);
+    for (int i = 0; i < numNonZero; i++) {
+        colIndices[i] = getColIndex(colNames[i]);
+        if (colIndices[i] == -1) Util::throwInvalidArgument("Error: In addRow, column %s was not found.", colNames[i].c_str());
+    }
+
+    addRow(numNonZero, colIndices.data(), elements.data(), rhs, sense, name);
+}
+
+// Row names are not used by the simplex
+void Simplex::addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name) {
+    if (sense != 'L' && sense != 'E' && sense != 'G')
+        Util::throwInvalidArgument("Error: In addRow, invalid sense %c (valid values are 'L', 'E' and 'G').", sense);
+    lp.addRow(numNonZero, colIndices, elements, rhs, sense);
+}
+
+/**
+ * GET DATA
+ *
+ */
+
+void Simplex::getColSolution() {
+    colSolution.assign(x.begin(), x.begin() + n);
+}
+
+/**
+ * SOLVE
+ *
+ */
+
+void Simplex::doSolve() {
+    if (isMIP()) Util::throwInvalidArgument("Error: The simplex solver only solves linear programs, relax the problem first (lp_relaxation = 1).");
+
+    startTime  = Util::getWallTime();
+    iterations = 0;
+    objValue   = 0;
+    status     = SIMPLEX_UNSOLVED;
+
+    setup();
+    iterationLimit = maxIterations > 0 ? maxIterations : 100 * (n + m) + 10000;
+    factoriseBasis();
+    computePrimal();
+
+    int result = dual();
+    if (result == -1 || result == SIMPLEX_OPTIMAL) result = primal();
+
+    // Recomputes the solution from a fresh factorisation, cleaning up if it drifted
+    if (result == SIMPLEX_OPTIMAL) {
+        factoriseBasis();
+        computePrimal();
+        for (int pos = 0; pos < m; pos++) {
+            int b = head[pos];
+            if (x[b] < lower[b] - SIMPLEX_PRIMAL_TOLERANCE || x[b] > upper[b] + SIMPLEX_PRIMAL_TOLERANCE) {
+                result = primal();
+                break;
+            }
+        }
+    }
+    status = result;
+
+    if (status == SIMPLEX_OPTIMAL) {
+        const double* obj = lp.getObj();
+        for (int j = 0; j < n; j++) objValue += obj[j] * x[j];
+    }
+
+    if (debug > 1) {
+        printf("Simplex: %d rows, %d columns, %d iterations in %.3fs, status = %d, objective = %.6f\n",
+               m, n, iterations, Util::getWallTime() - startTime, status, objValue);
+    }
+}
+
+/**
+ * Builds the standard form. The last basis is kept if rows and columns were only added since,
+ * new logicals are basic and new columns nonbasic.
+ */
+void Simplex::setup() {
+    int oldN = n;
+    int oldM = m;
+    vector<int>    oldHead;
+    vector<double> oldX;
+    oldHead.swap(head);
+    oldX.swap(x);
+
+    n = lp.getNumCols();
+    m = lp.getNumRows();
+
+    // Columns of A from the rows, only rebuilt if rows or columns were added
+    int numNonZeros = lp.getNumNonZeros();
+    if (n != oldN || m != oldM || (int)colBeg.size() != n + 1 || numNonZeros != (int)colInd.size()) {
+        colBeg.assign(n + 1, 0);
+        const int*    rowInd = lp.getRowInd();
+        const double* rowVal = lp.getRowVal();
+        for (int e = 0; e < numNonZeros; e++) colBeg[rowInd[e] + 1]++;
+        for (int j = 0; j < n; j++) colBeg[j+1] += colBeg[j];
+        colInd.resize(numNonZeros);
+        colVal.resize(numNonZeros);
+        vector<int> next(colBeg.begin(), colBeg.end() - 1);
+        for (int i = 0; i < m; i++) {
+            for (int e = lp.getRowBegin(i); e < lp.getRowEnd(i); e++) {
+                int k = next[rowInd[e]]++;
+                colInd[k] = i;
+                colVal[k] = rowVal[e];
+            }
+        }
+    }
+
+    cost.assign(n + m, 0.0);
+    lower.resize(n + m);
+    upper.resize(n + m);
+    double sign = lp.isMaximisation() ? -1.0 : 1.0;
+    for (int j = 0; j < n; j++) {
+        cost[j]  = sign * lp.getObj()[j];
+        lower[j] = lp.getLower()[j] <= -SIMPLEX_INFINITY ? -SIMPLEX_INFINITY : lp.getLower()[j];
+        upper[j] = lp.getUpper()[j] >=  SIMPLEX_INFINITY ?  SIMPLEX_INFINITY : lp.getUpper()[j];
+    }
+    for (int i = 0; i < m; i++) {
+        char   sense = lp.getSense()[i];
+        double rhs   = lp.getRhs()[i];
+        lower[n+i] = sense == 'L' ? -SIMPLEX_INFINITY : rhs;
+        upper[n+i] = sense == 'G' ?  SIMPLEX_INFINITY : rhs;
+    }
+
+    x.assign(n + m, 0.0);
+    head.resize(m);
+    int firstNewRow = 0;
+    if ((int)oldHead.size() == oldM && oldM > 0 && n >= oldN && m >= oldM) {
+        for (int j = 0; j < oldN; j++) x[j]   = oldX[j];
+        for (int i = 0; i < oldM; i++) x[n+i] = oldX[oldN+i];
+        for (int pos = 0; pos < oldM; pos++) head[pos] = oldHead[pos] < oldN ? oldHead[pos] : oldHead[pos] - oldN + n;
+        firstNewRow = oldM;
+    }
+    for (int i = firstNewRow; i < m; i++) head[i] = n + i;
+
+    posOf.assign(n + m, -1);
+    for (int pos = 0; pos < m; pos++) posOf[head[pos]] = pos;
+    for (int j = 0; j < n + m; j++) if (posOf[j] == -1) snapToBound(j);
+}
+
+// Nonbasic variables sit at the bound closest to their value, free ones at zero
+void Simplex::snapToBound(int j) {
+    bool hasLower = lower[j] > -SIMPLEX_INFINITY;
+    bool hasUpper = upper[j] <  SIMPLEX_INFINITY;
+    if (hasLower && hasUpper) x[j] = fabs(x[j] - upper[j]) < fabs(x[j] - lower[j]) ? upper[j] : lower[j];
+    else if (hasLower)        x[j] = lower[j];
+    else if (hasUpper)        x[j] = upper[j];
+    else                      x[j] = 0;
+}
+
+/**
+ * Positions whose column makes the basis singular get the logical of a row left without pivot
+ */
+void Simplex::factoriseBasis() {
+    vector<int>    beg(m + 1);
+    vector<int>    ind;
+    vector<double> val;
+    vector<int>    singularPos;
+    vector<int>    freeRows;
+
+    for (int attempt = 0; attempt <= m; attempt++) {
+        ind.clear();
+        val.clear();
+        for (int pos = 0; pos < m; pos++) {
+            beg[pos] = (int)ind.size();
+            int j = head[pos];
+            if (j < n) {
+                ind.insert(ind.end(), colInd.begin() + colBeg[j], colInd.begin() + colBeg[j+1]);
+                val.insert(val.end(), colVal.begin() + colBeg[j], colVal.begin() + colBeg[j+1]);
+            } else {
+                ind.push_back(j - n);
+                val.push_back(-1.0);
+            }
+        }
+        beg[m] = (int)ind.size();
+
+        if (factor.factorise(m, beg, ind, val, singularPos, freeRows)) return;
+
+        if (debug > 2) printf("Simplex: singular basis, %d columns replaced by logicals\n", (int)singularPos.size());
+        for (unsigned k = 0; k < singularPos.size(); k++) {
+            int pos = singularPos[k];
+            int old = head[pos];
+            head[pos] = n + freeRows[k];
+            posOf[n + freeRows[k]] = pos;
+            posOf[old] = -1;
+            snapToBound(old);
+        }
+    }
+    Util::throwInvalidArgument("Error: Simplex could not factorise the basis.");
+}
+
+// x_B = -B^-1 N x_N
+void Simplex::computePrimal() {
+    vector<double>& rhs = alpha;
+    rhs.assign(m, 0.0);
+    for (int j = 0; j < n; j++) {
+        if (posOf[j] != -1 || x[j] == 0) continue;
+        for (int e = colBeg[j]; e < colBeg[j+1]; e++) rhs[colInd[e]] -= colVal[e] * x[j];
+    }
+    for (int i = 0; i < m; i++) if (posOf[n+i] == -1) rhs[i] += x[n+i];
+
+    factor.ftran(rhs);
+    for (int pos = 0; pos < m; pos++) x[head[pos]] = rhs[pos];
+}
+
+// y = B^-T c_B, d = c - y A for nonbasic variables
+void Simplex::computeDuals(const vector<double>& c) {
+    y.assign(m, 0.0);
+    for (int pos = 0; pos < m; pos++) y[pos] = c[head[pos]];
+    factor.btran(y);
+
+    d.assign(n + m, 0.0);
+    for (int j = 0; j < n + m; j++) {
+        if (posOf[j] == -1) d[j] = c[j] - rowTimesColumn(y, j);
+    }
+}
+
+void Simplex::loadColumn(int j, vector<double>& a) {
+    a.assign(m, 0.0);
+    if (j < n) {
+        for (int e = colBeg[j]; e < colBeg[j+1]; e++) a[colInd[e]] = colVal[e];
+    } else {
+        a[j - n] = -1.0;
+    }
+}
+
+double Simplex::rowTimesColumn(const vector<double>& r, int j) {
+    if (j >= n) return -r[j - n];
+    double v = 0;
+    for (int e = colBeg[j]; e < colBeg[j+1]; e++) v += colVal[e] * r[colInd[e]];
+    return v;
+}
+
+// q enters the basis at pos, alpha must be its ftran
+void Simplex::pivot(int pos, int q) {
+    int leaving = head[pos];
+    factor.update(pos, alpha);
+    head[pos]     = q;
+    posOf[q]      = pos;
+    posOf[leaving] = -1;
+    iterations++;
+
+    if (factor.getNumUpdates() >= SIMPLEX_REFACTOR) {
+        factoriseBasis();
+        computePrimal();
+    }
+}
+
+bool Simplex::atLimit() {
+    if (iterations >= iterationLimit) {
+        status = SIMPLEX_ITERATION_LIMIT;
+        return true;
+    }
+    if (timeLimit > 0 && iterations % 50 == 0 && Util::getWallTime() - startTime > timeLimit) {
+        status = SIMPLEX_TIME_LIMIT;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Primal simplex, Dantzig pricing and Harris ratio test. While the basis is infeasible the
+ * costs are those of the sum of infeasibilities (phase 1).
+ */
+int Simplex::primal() {
+    vector<double> phaseCost(n + m, 0.0);
+    int degenerate = 0;
+
+    while (true) {
+        if (atLimit()) return status;
+
+        bool phase1 = false;
+        std::fill(phaseCost.begin(), phaseCost.end(), 0.0);
+        for (int pos = 0; pos < m; pos++) {
+            int b = head[pos];
+            if      (x[b] < lower[b] - SIMPLEX_PRIMAL_TOLERANCE) { phaseCost[b] = -1; phase1 = true; }
+            else if (x[b] > upper[b] + SIMPLEX_PRIMAL_TOLERANCE) { phaseCost[b] =  1; phase1 = true; }
+        }
+        computeDuals(phase1 ? phaseCost : cost);
+
+        // Pricing
+        bool bland = degenerate > SIMPLEX_MAX_DEGENERATE;
+        int    q    = -1;
+        double best = 0;
+        for (int j = 0; j < n + m; j++) {
+            if (posOf[j] != -1 || lower[j] == upper[j]) continue;
+            double score = 0;
+            if      (x[j] < upper[j] && d[j] < -SIMPLEX_DUAL_TOLERANCE) score = -d[j];
+            else if (x[j] > lower[j] && d[j] >  SIMPLEX_DUAL_TOLERANCE) score =  d[j];
+            if (score == 0) continue;
+            if (bland) {
+                q = j;
+                break;
+            }
+            if (score > best) {
+                best = score;
+                q = j;
+            }
+        }
+        if (q == -1) return phase1 ? SIMPLEX_INFEASIBLE : SIMPLEX_OPTIMAL;
+
+        loadColumn(q, alpha);
+        factor.ftran(alpha);
+        double dir = d[q] < 0 ? 1.0 : -1.0;
+
+        // Step at which basic variable b hits a bound (relaxed by tol), target is that bound
+        auto limit = [&](int b, double delta, double tol, double& target) {
+            if (phase1 && x[b] < lower[b] - SIMPLEX_PRIMAL_TOLERANCE) {
+                if (delta <= 0) return SIMPLEX_INFINITY;
+                target = lower[b];
+                return (lower[b] - x[b] + tol) / delta;
+            }
+            if (phase1 && x[b] > upper[b] + SIMPLEX_PRIMAL_TOLERANCE) {
+                if (delta >= 0) return SIMPLEX_INFINITY;
+                target = upper[b];
+                return (x[b] - upper[b] + tol) / -delta;
+            }
+            if (delta < 0 && lower[b] > -SIMPLEX_INFINITY) {
+                target = lower[b];
+                return std::max(0.0, x[b] - lower[b] + tol) / -delta;
+            }
+            if (delta > 0 && upper[b] <  SIMPLEX_INFINITY) {
+                target = upper[b];
+                return std::max(0.0, upper[b] - x[b] + tol) / delta;
+            }
+            return SIMPLEX_INFINITY;
+        };
+
+        // Harris ratio test: largest pivot among the rows blocking within the tolerance
+        double target = 0;
+        double maxStep = SIMPLEX_INFINITY;
+        for (int pos = 0; pos < m; pos++) {
+            if (fabs(alpha[pos]) < SIMPLEX_PIVOT_TOLERANCE) continue;
+            maxStep = std::min(maxStep, limit(head[pos], -dir * alpha[pos], SIMPLEX_PRIMAL_TOLERANCE, target));
+        }
+
+        double boundFlip = SIMPLEX_INFINITY;
+        if (lower[q] > -SIMPLEX_INFINITY && upper[q] < SIMPLEX_INFINITY) boundFlip = upper[q] - lower[q];
+        if (maxStep >= SIMPLEX_INFINITY && boundFlip >= SIMPLEX_INFINITY) return phase1 ? SIMPLEX_NUMERICAL : SIMPLEX_UNBOUNDED;
+
+        int    p = -1;
+        double step = SIMPLEX_INFINITY;
+        double leaveTarget = 0;
+        double bestPivot = 0;
+        for (int pos = 0; pos < m; pos++) {
+            if (fabs(alpha[pos]) < SIMPLEX_PIVOT_TOLERANCE) continue;
+            double t = limit(head[pos], -dir * alpha[pos], 0, target);
+            if (t > maxStep) continue;
+            bool better = bland ? (p == -1 || head[pos] < head[p]) : fabs(alpha[pos]) > bestPivot;
+            if (better) {
+                p = pos;
+                step = t;
+                leaveTarget = target;
+                bestPivot = fabs(alpha[pos]);
+            }
+        }
+
+        if (p == -1 || boundFlip <= step) {
+            x[q] = dir > 0 ? upper[q] : lower[q];
+            for (int pos = 0; pos < m; pos++) x[head[pos]] -= dir * boundFlip * alpha[pos];
+            iterations++;
+            degenerate = 0;
+            continue;
+        }
+
+        x[q] += dir * step;
+        for (int pos = 0; pos < m; pos++) x[head[pos]] -= dir * step * alpha[pos];
+        x[head[p]] = leaveTarget;
+        degenerate = step < 1e-12 ? degenerate + 1 : 0;
+        pivot(p, q);
+    }
+}
+
+/**
+ * Dual simplex, leaving variable by largest infeasibility and Harris ratio test.
+ * Returns -1 if the basis is not dual feasible.
+ */
+int Simplex::dual() {
+    computeDuals(cost);
+    for (int j = 0; j < n + m; j++) {
+        if (posOf[j] != -1) continue;
+        if (d[j] < -SIMPLEX_DUAL_TOLERANCE && upper[j] >= SIMPLEX_INFINITY) return -1;
+        if (d[j] >  SIMPLEX_DUAL_TOLERANCE && lower[j] <= -SIMPLEX_INFINITY) return -1;
+    }
+    for (int j = 0; j < n + m; j++) {
+        if (posOf[j] != -1 || lower[j] == upper[j]) continue;
+        if      (d[j] < -SIMPLEX_DUAL_TOLERANCE) x[j] = upper[j];
+        else if (d[j] >  SIMPLEX_DUAL_TOLERANCE) x[j] = lower[j];
+    }
+    computePrimal();
+
+    vector<int>    candidates;
+    vector<double> candidateAlpha;
+    while (true) {
+        if (atLimit()) return status;
+
+        int    p = -1;
+        double worst = SIMPLEX_PRIMAL_TOLERANCE;
+        for (int pos = 0; pos < m; pos++) {
+            int b = head[pos];
+            double infeasibility = std::max(lower[b] - x[b], x[b] - upper[b]);
+            if (infeasibility > worst) {
+                worst = infeasibility;
+                p = pos;
+            }
+        }
+        if (p == -1) return SIMPLEX_OPTIMAL;
+
+        computeDuals(cost);
+        int  b = head[p];
+        bool increase = x[b] < lower[b];
+
+        rho.assign(m, 0.0);
+        rho[p] = 1.0;
+        factor.btran(rho);
+
+        // x_b changes by -alpha_pj * dx_j
+        candidates.clear();
+        candidateAlpha.clear();
+        double maxRatio = SIMPLEX_INFINITY;
+        for (int j = 0; j < n + m; j++) {
+            if (posOf[j] != -1 || lower[j] == upper[j]) continue;
+            double a = rowTimesColumn(rho, j);
+            if (fabs(a) < SIMPLEX_PIVOT_TOLERANCE) continue;
+            double s = increase ? -a : a;
+            if (!((x[j] < upper[j] && s > 0) || (x[j] > lower[j] && s < 0))) continue;
+            candidates.push_back(j);
+            candidateAlpha.push_back(a);
+            maxRatio = std::min(maxRatio, (fabs(d[j]) + SIMPLEX_DUAL_TOLERANCE) / fabs(a));
+        }
+        if (candidates.empty()) return SIMPLEX_INFEASIBLE;
+
+        int    q = -1;
+        double bestPivot = 0;
+        for (unsigned k = 0; k < candidates.size(); k++) {
+            double a = fabs(candidateAlpha[k]);
+            if (fabs(d[candidates[k]]) / a <= maxRatio && a > bestPivot) {
+                bestPivot = a;
+                q = candidates[k];
+            }
+        }
+
+        loadColumn(q, alpha);
+        factor.ftran(alpha);
+        if (fabs(alpha[p]) < SIMPLEX_PIVOT_TOLERANCE) {
+            // Row and column disagree, the factorisation lost accuracy
+            if (factor.getNumUpdates() == 0) return SIMPLEX_NUMERICAL;
+            factoriseBasis();
+            computePrimal();
+            continue;
+        }
+
+        double target = increase ? lower[b] : upper[b];
+        double theta  = (x[b] - target) / alpha[p];
+        x[q] += theta;
+        for (int pos = 0; pos < m; pos++) x[head[pos]] -= theta * alpha[pos];
+        x[b] = target;
+        pivot(p, q);
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * Simplex.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SIMPLEX_H
+#define SIMPLEX_H
+
+#include "Solver.h"
+#include "BasisFactor.h"
+
+enum SimplexStatus {
+    SIMPLEX_UNSOLVED = 0,
+    SIMPLEX_OPTIMAL,
+    SIMPLEX_INFEASIBLE,
+    SIMPLEX_UNBOUNDED,
+    SIMPLEX_ITERATION_LIMIT,
+    SIMPLEX_TIME_LIMIT,
+    SIMPLEX_NUMERICAL
+};
+
+/**
+ * Built-in LP solver, bounded revised simplex.
+ *
+ * Every row i gets a logical variable r_i = a_i x, bounded according to the sense
+ * of the row, so that the problem is min c x s.t. A x - r = 0, l <= (x, r) <= u.
+ * The initial basis is made of the logicals. If the basis is dual feasible (possibly
+ * after moving boxed variables to their other bound) the dual simplex is used, the
+ * primal simplex (phase 1 minimises the sum of infeasibilities) finishes the job.
+ * The basis is kept between solves, so that re-solving after adding rows or columns
+ * or changing bounds starts from the last one.
+ *
+ * Integrality is ignored, MIPs must be relaxed (relax()) before being solved.
+ */
+class Simplex : public Solver {
+
+    private:
+
+        // Problem as added
+        ModelIR lp;
+        bool relaxed;
+
+        // Parameters
+        double timeLimit;
+        int debug;
+
+        // Problem in standard form, logicals are the variables [n, n + m)
+        int n;
+        int m;
+        vector<int>    colBeg;
+        vector<int>    colInd;
+        vector<double> colVal;
+        vector<double> cost;
+        vector<double> lower;
+        vector<double> upper;
+        vector<double> x;
+
+        // Basis: variable at each position, position of each variable (-1 if nonbasic)
+        vector<int> head;
+        vector<int> posOf;
+        BasisFactor factor;
+
+        // Work vectors
+        vector<double> y;
+        vector<double> d;
+        vector<double> alpha;
+        vector<double> rho;
+
+        double objValue;
+        int iterations;
+        int iterationLimit;
+        int maxIterations;
+        double startTime;
+
+        void setup();
+        void factoriseBasis();
+        void computePrimal();
+        void computeDuals(const vector<double>& c);
+        void loadColumn(int j, vector<double>& a);
+        double rowTimesColumn(const vector<double>& r, int j);
+        void pivot(int pos, int q);
+        void snapToBound(int j);
+        bool atLimit();
+        int  primal();
+        int  dual();
+
+    protected:
+
+        const ModelIR& getProblem() const { return lp; }
+        int getMaxIterations() const { return maxIterations; }
+
+    public:
+
+        Simplex();
+        virtual ~Simplex();
+        virtual void deleteAndRecreateProblem();
+        virtual int isMIP();
+
+        // Set data
+        virtual void changeObjectiveSense(bool isMax);
+        virtual int addVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addVariables(int numCols, const double lower, const double upper, const double* obj, string& name);
+        virtual int addBinaryVariable(const double obj, string name);
+        virtual int addBinaryVariables(int numCols, const double* obj, string& name);
+        virtual int addIntegerVariable(const double lower, const double upper, const double obj, string name);
+        virtual int addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name);
+        virtual void addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name);
+        virtual void addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = "");
+        virtual void setColBounds(int col, double lower, double upper) { lp.setBounds(col, lower, upper); }
+        virtual void relax() { relaxed = true; }
+
+        // Solve
+        virtual void doSolve();
+
+        // Get data
+        virtual int getNumCols() { return lp.getNumCols(); }
+        virtual int getNumRows() { return lp.getNumRows(); }
+        virtual int getStatus()  { return status;          }
+        virtual double getObjValue()  { return objValue;   }
+        virtual double getBestBound() { return objValue;   }
+        virtual void getColSolution();
+        int getIterations()      { return iterations;      }
+
+        // Params
+        virtual void setTimeLimit(double time) { timeLimit = time; }
+        // 0 keeps the default limit, which grows with the size of the problem
+        void setIterationLimit(int lim) { maxIterations = lim; }
+
+        // Debug
+        virtual void printSolverName();
+        virtual void debugInformation(int d) { debug = d; }
+
+        // Status
+        virtual bool solutionExists()          { return status == SIMPLEX_OPTIMAL;    }
+        virtual bool isOptimal()               { return status == SIMPLEX_OPTIMAL;    }
+        virtual bool isInfeasible()            { return status == SIMPLEX_INFEASIBLE; }
+        virtual bool isUnbounded()             { return status == SIMPLEX_UNBOUNDED;  }
+        virtual bool isTimeLimit()             { return status == SIMPLEX_TIME_LIMIT; }
+        virtual bool isIterationLimitReached() { return status == SIMPLEX_ITERATION_LIMIT; }
+        virtual bool isNumericalDifficulties() { return status == SIMPLEX_NUMERICAL;  }
+};
+
+#endif
@@ -7,12 +7,12 @@
  */
 
 #include "Solution.h"
-#include "Options.h"
 
-Solution::Solution() {
+Solution::Solution(RunContext* ctx) {
     
     resetSolution();
-    debug = Options::getInstance()->getIntOption("debug");
+    context = ctx ? ctx : RunContext::getDefault();
+    debug   = context->getOptions()->getIntOption("debug");
     
 }
 
@@ -43,18 +43,18 @@ void Solution::print(int overrideDebug) {
     int ddebug = overrideDebug == -1 ? debug : overrideDebug;
     if (!debug) return;
 
-    printf("\n------\nSolution:\n\n");
+    context->print("\n------\nSolution:\n\n");
     if (!solutionExists) {
-         if (isInfeasible)     printf("Model is infeasible\n");
-         else if (isUnbounded) printf("Model is unbounded\n");
-         else                  printf("Solution does not exist\n");
+         if (isInfeasible)     context->print("Model is infeasible\n");
+         else if (isUnbounded) context->print("Model is unbounded\n");
+         else                  context->print("Solution does not exist\n");
     } else {
         
-        printf("Solution %s (gap: %.2f%%)\n", isOptimal ? "is optimal" : "is not optimal", getGap()*100);
-        printf("Obj   = %.5f\n", value);
-        if (ddebug > 1) printf("Bound = %.5f\n", bestBound);
+        context->print("Solution %s (gap: %.2f%%)\n", isOptimal ? "is optimal" : "is not optimal", getGap()*100);
+        context->print("Obj   = %.5f\n", value);
+        if (ddebug > 1) context->print("Bound = %.5f\n", bestBound);
     }
-    printf("-----\n");
+    context->print("-----\n");
  
 }
 
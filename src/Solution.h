@@ -11,6 +11,7 @@
 
 #include "Util.h"
 #include "Data.h"
+#include "RunContext.h"
 
 
 class Solution {
@@ -26,11 +27,12 @@ class Solution {
         bool isUnbounded;
 
         int debug;
+        RunContext* context;
 
     public:
    
 
-        Solution();
+        Solution(RunContext* ctx = NULL);
         ~Solution();
       
         void setSolutionStatus(bool exists, bool optimal, bool infeasible, bool unbounded);
@@ -0,0 +1,128 @@
+/**
+ * SolveHandle.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "SolveHandle.h"
+#include <chrono>
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+SolveHandle::SolveHandle(Solver* s) {
+    solver         = s;
+    previous       = NULL;
+    done           = false;
+    incumbentFound = false;
+    boundFound     = false;
+    incumbent      = 0;
+    bound          = 0;
+    nodes          = 0;
+    cancelled      = false;
+    startTime      = Util::getWallTime();
+
+    thread = std::thread(&SolveHandle::run, this);
+}
+
+SolveHandle::~SolveHandle() {
+    if (!isDone()) cancel();
+    if (thread.joinable()) thread.join();
+}
+
+/**
+ * SOLVE
+ *
+ */
+
+void SolveHandle::run() {
+    previous = solver->getListener();
+    solver->setListener(this);
+    try {
+        solver->solve();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    solver->setListener(previous);
+
+    // Final values, progress may not have been reported at all
+    if (!error) nodes = solver->getNodeCount();
+    if (!error && solver->solutionExists() && !solver->isInfeasible() && !solver->isUnbounded()) {
+        incumbent      = solver->getObjValue();
+        incumbentFound = true;
+        bound          = solver->getBestBound();
+        boundFound     = true;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    done = true;
+    finished.notify_all();
+}
+
+bool SolveHandle::isDone() {
+    std::lock_guard<std::mutex> guard(lock);
+    return done;
+}
+
+void SolveHandle::wait() {
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        finished.wait(guard, [this]() { return done; });
+    }
+    if (thread.joinable()) thread.join();
+    if (error) {
+        std::exception_ptr e = error;
+        error = NULL;
+        std::rethrow_exception(e);
+    }
+}
+
+bool SolveHandle::waitFor(double seconds) {
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (!finished.wait_for(guard, std::chrono::duration<double>(seconds), [this]() { return done; })) return false;
+    }
+    wait();
+    return true;
+}
+
+void SolveHandle::cancel() {
+    cancelled = true;
+    solver->terminate();
+}
+
+/**
+ * PROGRESS
+ *
+ */
+
+double SolveHandle::getElapsedTime() {
+    return Util::getWallTime() - startTime;
+}
+
+double SolveHandle::getGap() {
+    if (!incumbentFound || !boundFound) return -1;
+    double value = incumbent;
+    return fabs(value - bound) / (1e-10 + fabs(value));
+}
+
+void SolveHandle::newIncumbent(Solver* s, double value) {
+    incumbent      = value;
+    incumbentFound = true;
+    if (previous) previous->newIncumbent(s, value);
+}
+
+void SolveHandle::newBound(Solver* s, double value) {
+    bound      = value;
+    boundFound = true;
+    if (previous) previous->newBound(s, value);
+}
+
+void SolveHandle::newNodeCount(Solver* s, int count) {
+    nodes = count;
+    if (previous) previous->newNodeCount(s, count);
+}
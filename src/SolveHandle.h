@@ -0,0 +1,81 @@
+/**
+ * SolveHandle.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SOLVEHANDLE_H
+#define SOLVEHANDLE_H
+
+#include "Solver.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+/**
+ * A solve running on its own thread, as started by Solver::solveAsync.
+ *
+ * The incumbent, bound and node count are those last reported by the solver while solving, and
+ * the final ones once it is done. Cancelling asks the solver to terminate, the solve still has
+ * to be waited for. Deleting the handle cancels the solve (if still running) and waits for it.
+ *
+ * The solver must not be used while the solve runs, except through the handle. A listener the
+ * solver already had keeps being told about the progress.
+ */
+class SolveHandle : public SolverListener {
+
+    private:
+
+        Solver* solver;
+        SolverListener* previous;
+        std::thread thread;
+        std::exception_ptr error;
+
+        std::mutex lock;
+        std::condition_variable finished;
+        bool done;
+
+        std::atomic<bool>   incumbentFound;
+        std::atomic<bool>   boundFound;
+        std::atomic<double> incumbent;
+        std::atomic<double> bound;
+        std::atomic<int>    nodes;
+        std::atomic<bool>   cancelled;
+        double startTime;
+
+        void run();
+
+    public:
+
+        SolveHandle(Solver* s);
+        virtual ~SolveHandle();
+
+        // Whether the solve has finished
+        bool isDone();
+        // Waits until the solve finishes, rethrowing any error it raised
+        void wait();
+        // Waits at most seconds, returns whether the solve has finished
+        bool waitFor(double seconds);
+        void cancel();
+
+        Solver* getSolver()      { return solver;           }
+        bool isCancelled()       { return cancelled;        }
+        bool hasIncumbent()      { return incumbentFound;   }
+        bool hasBound()          { return boundFound;       }
+        double getIncumbent()    { return incumbent;        }
+        double getBound()        { return bound;            }
+        int getNodeCount()       { return nodes;            }
+        double getElapsedTime();
+        // Relative gap as computed by CPLEX, -1 if there is no incumbent or bound yet
+        double getGap();
+
+        virtual void newIncumbent (Solver* s, double value);
+        virtual void newBound     (Solver* s, double value);
+        virtual void newNodeCount (Solver* s, int count);
+};
+
+#endif
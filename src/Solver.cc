@@ -7,6 +7,7 @@
  */
 
 #include "Solver.h"
+#include "SolveHandle.h"
 
 /**
  * INITIAL METHODS
@@ -15,36 +16,199 @@
 
 Solver::Solver() {
     status = 0;
+    useNames = true;
+    listener = NULL;
+    colFormattersIndexed = 0;
+    colFormattersWritten = 0;
+    rowFormattersWritten = 0;
+    colsWritten          = 0;
 }
 
 Solver::~Solver() {
 }
 
 string Solver::getColName(int index) {
-    for (auto &i : colIndices) {
-        if (i.second == index) {
-            return i.first;
+    const char* name = colNames.getName(index);
+    if (name != NULL) return name;
+
+    const NameFormatterBlock* block = findFormatter(colFormatters, index);
+    if (block == NULL) Util::throwInvalidArgument("Column not found in getColName"); 
+    return block->format(index - block->first);
+}
+
+int Solver::getColIndex(const string& name) {
+    if (colFormattersIndexed.load(std::memory_order_acquire) == (int)colFormatters.size()) return colNames.find(name);
+
+    std::lock_guard<std::mutex> guard(indexLock);
+    int index = colNames.find(name);
+    int indexed = colFormattersIndexed.load(std::memory_order_relaxed);
+    if (index != -1 || indexed == (int)colFormatters.size()) return index;
+
+    // Anonymous columns are only indexed by name the first time a name is looked up
+    for (; indexed < (int)colFormatters.size(); indexed++) {
+        const NameFormatterBlock& block = colFormatters[indexed];
+        for (int i = 0; i < block.num; i++) addKey(block.format(i), block.first + i);
+    }
+    colFormattersIndexed.store(indexed, std::memory_order_release);
+    return colNames.find(name);
+}
+
+void Solver::addKey(const string& name, int index) {
+    colNames.add(name, index);
+}
+
+void Solver::clearKeys() {
+    colNames.clear();
+    colFormatters.clear();
+    rowFormatters.clear();
+    colFormattersIndexed = 0;
+    colFormattersWritten = 0;
+    rowFormattersWritten = 0;
+    colsWritten          = 0;
+}
+
+void Solver::addFormatter(vector<NameFormatterBlock>& formatters, int first, int num, NameFormatter format) {
+    if (!formatters.empty() && first < formatters.back().first + formatters.back().num) 
+        Util::throwInvalidArgument("Error: Name blocks must be assigned in increasing order of index (%d).", first);
+    NameFormatterBlock block;
+    block.first  = first;
+    block.num    = num;
+    block.format = format;
+    formatters.push_back(block);
+}
+
+const NameFormatterBlock* Solver::findFormatter(const vector<NameFormatterBlock>& formatters, int index) {
+    auto it = std::upper_bound(formatters.begin(), formatters.end(), index, 
+                               [](int i, const NameFormatterBlock& b) { return i < b.first; });
+    if (it == formatters.begin()) return NULL;
+    --it;
+    if (index >= it->first + it->num) return NULL;
+    return &(*it);
+}
+
+void Solver::setColNames(int firstCol, int numCols, NameFormatter format) {
+    if (numCols <= 0) return;
+    if (!useNames) {
+        addFormatter(colFormatters, firstCol, numCols, format);
+        return;
+    }
+    vector<int>    indices(numCols);
+    vector<string> names(numCols);
+    for (int i = 0; i < numCols; i++) {
+        indices[i] = firstCol + i;
+        names[i]   = format(i);
+        addKey(names[i], indices[i]);
+    }
+    writeColNames(indices, names);
+}
+
+void Solver::setRowNames(int firstRow, int numRows, NameFormatter format) {
+    if (numRows <= 0) return;
+    if (!useNames) {
+        addFormatter(rowFormatters, firstRow, numRows, format);
+        return;
+    }
+    vector<int>    indices(numRows);
+    vector<string> names(numRows);
+    for (int i = 0; i < numRows; i++) {
+        indices[i] = firstRow + i;
+        names[i]   = format(i);
+    }
+    writeRowNames(indices, names);
+}
+
+void Solver::flushNames() {
+    if (useNames) return;
+    
+    vector<int>    indices;
+    vector<string> names;
+    
+    // Explicitly named columns were only stored in colNames
+    int numCols = getNumCols();
+    for (; colsWritten < numCols; colsWritten++) {
+        const char* name = colNames.getName(colsWritten);
+        if (name == NULL) continue;
+        indices.push_back(colsWritten);
+        names.push_back(name);
+    }
+    for (; colFormattersWritten < (int)colFormatters.size(); colFormattersWritten++) {
+        const NameFormatterBlock& block = colFormatters[colFormattersWritten];
+        for (int i = 0; i < block.num; i++) {
+            indices.push_back(block.first + i);
+            names.push_back(block.format(i));
         }
     }
-    Util::throwInvalidArgument("Column not found in getColName"); 
-    string c = "";
-    return c;
+    if (!indices.empty()) writeColNames(indices, names);
 
+    indices.clear();
+    names.clear();
+    for (; rowFormattersWritten < (int)rowFormatters.size(); rowFormattersWritten++) {
+        const NameFormatterBlock& block = rowFormatters[rowFormattersWritten];
+        for (int i = 0; i < block.num; i++) {
+            indices.push_back(block.first + i);
+            names.push_back(block.format(i));
+        }
+    }
+    if (!indices.empty()) writeRowNames(indices, names);
 }
 
-int Solver::getColIndex(string name) {
-    if (colIndices.find(name) == colIndices.end()) {
-        return -1;
-    } else {
-        return colIndices[name];
+/**
+ * Generic loading through the add functions. Consecutive columns with the same type and 
+ * bounds are added together. Binary columns are added in [0, 1], other bounds (e.g. fixed
+ * binaries) are set afterwards.
+ */
+void Solver::loadModel(const ModelIR& ir) {
+    if (getNumCols() > 0 || getNumRows() > 0) Util::throwInvalidArgument("Error: A model can only be loaded into an empty problem.");
+
+    changeObjectiveSense(ir.isMaximisation());
+
+    string noName;
+    const double* obj   = ir.getObj();
+    const double* lower = ir.getLower();
+    const double* upper = ir.getUpper();
+    const char*   types = ir.getTypes();
+    int numCols = ir.getNumCols();
+    int last;
+    for (int first = 0; first < numCols; first = last) {
+        for (last = first + 1; last < numCols; last++) {
+            if (types[last] != types[first] || lower[last] != lower[first] || upper[last] != upper[first]) break;
+        }
+        if (types[first] == 'B') {
+            int firstCol = addBinaryVariables(last - first, obj + first, noName);
+            if (firstCol != -1 && (lower[first] != 0 || upper[first] != 1)) {
+                for (int c = firstCol; c < firstCol + last - first; c++) setColBounds(c, lower[first], upper[first]);
+            }
+        } else if (types[first] == 'I') {
+            addIntegerVariables(last - first, lower[first], upper[first], obj + first, noName);
+        } else {
+            addVariables(last - first, lower[first], upper[first], obj + first, noName);
+        }
+    }
+
+    for (int r = 0; r < ir.getNumRows(); r++) {
+        int begin = ir.getRowBegin(r);
+        addRow(ir.getRowEnd(r) - begin, ir.getRowInd() + begin, ir.getRowVal() + begin, ir.getRhs()[r], ir.getSense()[r]);
     }
+    
+    loadNames(ir);
 }
 
-void Solver::addKey(string name, int index) {
-    colIndices[name] = index;
+/**
+ * Explicit row names are only passed to the solver if names are enabled, as in addRow
+ */
+void Solver::loadNames(const ModelIR& ir) {
+    const vector<int>&    namedCols = ir.getNamedCols();
+    const vector<string>& colNames  = ir.getColNames();
+    for (unsigned i = 0; i < namedCols.size(); i++) addKey(colNames[i], namedCols[i]);
+    if (useNames && !namedCols.empty()) writeColNames(namedCols, colNames);
+    
+    for (const NameFormatterBlock& block : ir.getColFormatters()) setColNames(block.first, block.num, block.format);
+
+    if (useNames && !ir.getNamedRows().empty()) writeRowNames(ir.getNamedRows(), ir.getRowNames());
+    for (const NameFormatterBlock& block : ir.getRowFormatters()) setRowNames(block.first, block.num, block.format);
 }
 
-double Solver::getColValue(string name) {
+double Solver::getColValue(const string& name) {
     if ((int)colSolution.size() == 0) {
         getColSolution();
     }
@@ -55,11 +219,23 @@ double Solver::getColValue(string name) {
 }
 
 
+const double* Solver::getColValues() {
+    if ((int)colSolution.size() == 0) {
+        getColSolution();
+    }
+    return colSolution.data();
+}
+
+
 void Solver::solve() {
     colSolution.clear();
     doSolve();
 }
 
+SolveHandle* Solver::solveAsync() {
+    return new SolveHandle(this);
+}
+
 void Solver::printSolverName() {
     printf("Generic solver assigned\n");
 }
@@ -10,6 +10,10 @@
 #define SOLVER_H
 
 #include "Util.h"
+#include "NameIndex.h"
+#include "ModelIR.h"
+#include <atomic>
+#include <mutex>
 
 // Error checking
 class SolverError {
@@ -23,6 +27,23 @@ class SolverError {
 };
 
 
+class Solver;
+class SolveHandle;
+
+/**
+ * Told about the progress of a solve, possibly from the solver's own threads. Values are in terms
+ * of the objective as given (not negated for maximisation problems)
+ */
+class SolverListener {
+
+    public:
+
+        virtual ~SolverListener() {}
+        virtual void newIncumbent(Solver* solver, double value) {}
+        virtual void newBound    (Solver* solver, double bound) {}
+        virtual void newNodeCount(Solver* solver, int nodes)    {}
+};
+
 
 /**
  * Solver, superclass of cplex, gurobi, etc.
@@ -31,16 +52,44 @@ class Solver {
 
     private:
        
-        map<string, int> colIndices;
+        NameIndex colNames;
+
+        // Names of anonymous columns and rows, generated only when needed
+        vector<NameFormatterBlock> colFormatters;
+        vector<NameFormatterBlock> rowFormatters;
+        // Names are looked up from callbacks, possibly on several threads. Once every anonymous column
+        // is indexed lookups need no lock
+        std::atomic<int> colFormattersIndexed;
+        std::mutex indexLock;
+        int colFormattersWritten;
+        int rowFormattersWritten;
+        int colsWritten;
+
+        const NameFormatterBlock* findFormatter(const vector<NameFormatterBlock>& formatters, int index);
+        void addFormatter(vector<NameFormatterBlock>& formatters, int first, int num, NameFormatter format);
 
 
     protected:
 
         int status;
         vector<double> colSolution;
+        SolverListener* listener;
+
+        // If false, names are not passed to the solver when columns and rows are added
+        bool useNames;
 
         // Map
-        void addKey(string name, int index);
+        void addKey(const string& name, int index);
+        void clearKeys();
+
+        // Passes names to the solver
+        virtual void writeColNames(const vector<int>& indices, const vector<string>& names) {}
+        virtual void writeRowNames(const vector<int>& indices, const vector<string>& names) {}
+        
+        // Writes to the solver every name not yet written. Called before the solver needs them (e.g. to export the model)
+        void flushNames();
+        // Names of a model being loaded
+        void loadNames(const ModelIR& ir);
         
         // Called by the superclass, actually solves the problem
         virtual void doSolve(){}
@@ -54,27 +103,52 @@ class Solver {
         virtual void readProblem(string filename) {}
         virtual int isMIP() {return 0;}
 
+        // Columns and rows added between beginBuild and endBuild may be buffered and passed to the 
+        // solver in bulk, at most maxBytes at a time. Column and row indices are assigned as usual
+        virtual void beginBuild(size_t maxBytes) {}
+        virtual void endBuild() {}
+
+        // Loads a whole model into an empty problem. Column and row indices are those of the IR
+        virtual void loadModel(const ModelIR& ir);
+
         // Map
-        int getColIndex(string name);
+        int getColIndex(const string& name);
         string getColName (int index);
-        double getColValue(string name);
+        double getColValue(const string& name);
+        // Whole solution, indexed by column
+        const double* getColValues();
+        size_t getColNamesMemoryUsage() { return colNames.getMemoryUsage(); }
+
+        // Names
+        void setNamesEnabled(bool enable) { useNames = enable; }
+        bool namesEnabled()               { return useNames;   }
+        // Names columns [firstCol, firstCol + numCols) with format(col - firstCol). If names are
+        // enabled this is done right away, otherwise only when a name is needed
+        virtual void setColNames(int firstCol, int numCols, NameFormatter format);
+        virtual void setRowNames(int firstRow, int numRows, NameFormatter format);
 
         // Set data
+        // Variables return the index of the (first) column added, -1 if nothing was added
         virtual void changeObjectiveSense(bool isMax){}
-        virtual void addVariable(const double lower, const double upper, const double obj, string name){}
-        virtual void addVariables(int numCols, const double lower, const double upper, const double* obj, string& name){}
-        virtual void addBinaryVariable(const double obj, string name){}
-        virtual void addBinaryVariables(int numCols, const double* obj, string& name){}
-        virtual void addIntegerVariable(const double lower, const double upper, const double obj, string name){}
-        virtual void addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name){}
+        virtual int addVariable(const double lower, const double upper, const double obj, string name){ return -1; }
+        virtual int addVariables(int numCols, const double lower, const double upper, const double* obj, string& name){ return -1; }
+        virtual int addBinaryVariable(const double obj, string name){ return -1; }
+        virtual int addBinaryVariables(int numCols, const double* obj, string& name){ return -1; }
+        virtual int addIntegerVariable(const double lower, const double upper, const double obj, string name){ return -1; }
+        virtual int addIntegerVariables(int numCols, double lb, double ub, const double* obj, string& name){ return -1; }
         // SENSE
         // L - <=
         // E - ==
         // G - >=
         virtual void addRow(vector<string> colNames, vector<double> elements, double rhs, char sense, string name){}
+        virtual void addRow(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = ""){}
 
         virtual void addLazyConstraint(vector<string> colNames, vector<double> elements, double rhs, char sense, string name){}
+        virtual void addLazyConstraint(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = ""){}
         virtual void addUserCut(vector<string> colNames, vector<double> elements, double rhs, char sense, string name){}
+        virtual void addUserCut(int numNonZero, const int* colIndices, const double* elements, double rhs, char sense, string name = ""){}
+
+        virtual void setColBounds(int col, double lower, double upper){}
          
         virtual void setPriorityInBranching(vector<string> colNames, int priority){}
         virtual void setPriorityInBranching(vector<string> colNames, vector<int> priorities){}
@@ -86,6 +160,14 @@ class Solver {
         virtual void relax(){} 
         // Implemented in the superclass, class the subclass method
         void solve();
+        // Solves on another thread, the handle (to be deleted by the caller) tells the progress and can cancel it
+        SolveHandle* solveAsync();
+
+        // The following may be called from another thread while solving
+        // Solutions not better than value are of no interest
+        virtual void setCutoff(double value) {}
+        // Asks the current solve (or the next one, if none is running) to stop as soon as possible
+        virtual void terminate() {}
 
         // Get data
         virtual int getNumCols(){ return 0; }
@@ -110,6 +192,8 @@ class Solver {
         virtual void setSolverCuts(int solverCuts = -2, int clique   = -2, int cover    = -2, int disj = -2, int landp  = -2, 
                                    int flowcover  = -2, int flowpath = -2, int gomory   = -2, int gub  = -2, int implbd = -2,
                                    int mir        = -2, int mcf      = -2, int zerohalf = -2) {}
+        // User cuts of the callbacks added per round (0 for no limit), and how parallel to an added one a cut may be (see CutSelector)
+        virtual void setCutSelection(int budget, double maxParallelism) {}
         
         // 0 - balanced, 1 - feasibility, 2 - optimality
         virtual void setMIPEmphasis(int t) {}
@@ -152,7 +236,8 @@ class Solver {
         virtual void addNodeCallback     (void* userData) {}
         virtual void addSolveCallback    (void* userData) {}
         virtual void addInfoCallback     (void* userData) {}
-
+        virtual void setListener(SolverListener* l) { listener = l;    }
+        SolverListener* getListener()               { return listener; }
 
 };    
 
@@ -248,8 +333,8 @@ class SolverCut {
         int         getNumCoefs() { return (int)coefs.size();         }
         double           getRHS() { return rhs;                       }
         char           getSense() { return sense;                     }
-        vector<double> getCoefs() { return coefs;                     }
-        vector<int>  getIndices() { return indices;                   }
+        const vector<double>& getCoefs()   { return coefs;            }
+        const vector<int>&    getIndices() { return indices;          }
         unsigned  getNumIndices() { return indices.size();            }
         int       getIndex(int i) { return indices[i];                }
         double     getCoef(int i) { return coefs[i];                  }
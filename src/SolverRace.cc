@@ -0,0 +1,129 @@
+/**
+ * SolverRace.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "SolverRace.h"
+#include <thread>
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+SolverRace::SolverRace(bool isMaximisation, double relativeGap) {
+    isMax     = isMaximisation;
+    gap       = relativeGap;
+    done      = false;
+    holder    = -1;
+    prover    = -1;
+    bestValue = 0;
+    bestBound = 0;
+    hasBound  = false;
+}
+
+SolverRace::~SolverRace() {
+}
+
+int SolverRace::add(Solver* solver, const string& description) {
+    Runner r;
+    r.solver      = solver;
+    r.description = description;
+    runners.push_back(r);
+    return (int)runners.size() - 1;
+}
+
+int SolverRace::indexOf(Solver* solver) {
+    for (unsigned i = 0; i < runners.size(); i++) if (runners[i].solver == solver) return i;
+    return -1;
+}
+
+/**
+ * SOLVE
+ *
+ */
+
+void SolverRace::solve() {
+    for (Runner& r : runners) r.solver->setListener(this);
+
+    vector<std::thread> threads;
+    for (int i = 0; i < (int)runners.size(); i++) threads.emplace_back(&SolverRace::run, this, i);
+    for (auto& t : threads) t.join();
+
+    for (Runner& r : runners) r.solver->setListener(NULL);
+}
+
+void SolverRace::run(int i) {
+    runners[i].solver->solve();
+    finish(i);
+}
+
+/**
+ * A solver that stops by itself, rather than because of a limit or because it was asked to, has proved
+ * that nothing better than the cutoff it was given exists. Its own incumbent, if any, may not have been
+ * reported yet.
+ */
+void SolverRace::finish(int i) {
+    Solver* s = runners[i].solver;
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (s->solutionExists() && !s->isInfeasible() && !s->isUnbounded()) {
+        double value = s->getObjValue();
+        if (holder == -1 || better(value, bestValue)) {
+            bestValue = value;
+            holder    = i;
+        }
+    }
+    if (done) return;
+    if (s->isOptimal() || s->isIntegerOptimal() || s->isInfeasible() || s->isUnbounded() || s->isInfeasibleOrUnbounded()) {
+        prover = i;
+        done   = true;
+        for (Runner& r : runners) r.solver->terminate();
+        return;
+    }
+
+    // Stopped by a limit, its final bound holds for every solver
+    double bound = s->getBestBound();
+    if (!hasBound || better(bestBound, bound)) {
+        bestBound = bound;
+        hasBound  = true;
+    }
+}
+
+// Gap as CPLEX computes it
+void SolverRace::checkGap(int i) {
+    if (done || holder == -1 || !hasBound) return;
+    if (fabs(bestValue - bestBound) > gap * (1e-10 + fabs(bestValue))) return;
+
+    prover = i;
+    done   = true;
+    for (Runner& r : runners) r.solver->terminate();
+}
+
+/**
+ * LISTENER
+ *
+ */
+
+void SolverRace::newIncumbent(Solver* solver, double value) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (holder != -1 && !better(value, bestValue)) return;
+
+    int i = indexOf(solver);
+    bestValue = value;
+    holder    = i;
+    for (int j = 0; j < (int)runners.size(); j++) if (j != i) runners[j].solver->setCutoff(value);
+    checkGap(i);
+}
+
+void SolverRace::newBound(Solver* solver, double bound) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (hasBound && !better(bestBound, bound)) return;
+
+    bestBound = bound;
+    hasBound  = true;
+    checkGap(indexOf(solver));
+}
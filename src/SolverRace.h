@@ -0,0 +1,80 @@
+/**
+ * SolverRace.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SOLVERRACE_H
+#define SOLVERRACE_H
+
+#include "Solver.h"
+#include <atomic>
+#include <mutex>
+
+/**
+ * Solves the same problem with several solvers (configurations) at the same time, one thread each.
+ *
+ * Whenever a solver finds a better incumbent its value is passed to the others as a cutoff. The
+ * race stops, and every solver is asked to terminate, as soon as one of them finishes by itself
+ * (proving that nothing better than the best incumbent exists) or the best bound of any of them
+ * closes the gap to the best incumbent.
+ *
+ * Solvers are not owned by the race.
+ */
+class SolverRace : public SolverListener {
+
+    private:
+
+        struct Runner {
+            Solver* solver;
+            string  description;
+        };
+
+        vector<Runner> runners;
+        bool   isMax;
+        double gap;
+
+        std::mutex lock;
+        std::atomic<bool> done;
+        int    holder;
+        int    prover;
+        double bestValue;
+        double bestBound;
+        bool   hasBound;
+
+        int  indexOf(Solver* solver);
+        bool better(double a, double b) { return isMax ? a > b : a < b; }
+        void run(int i);
+        void checkGap(int i);
+        void finish(int i);
+
+    public:
+
+        SolverRace(bool isMaximisation, double relativeGap);
+        virtual ~SolverRace();
+
+        // Returns the index of the solver in the race
+        int add(Solver* solver, const string& description);
+        void solve();
+
+        virtual void newIncumbent(Solver* solver, double value);
+        virtual void newBound    (Solver* solver, double bound);
+
+        int getNumSolvers()                 { return (int)runners.size();     }
+        Solver* getSolver(int i)            { return runners[i].solver;       }
+        const string& getDescription(int i) { return runners[i].description;  }
+
+        // Solver that found the best incumbent, -1 if none
+        int getHolder()                     { return holder;                  }
+        // Solver that closed the race, -1 if the race ended because every solver stopped
+        int getProver()                     { return prover;                  }
+        // Whether the best incumbent (or infeasibility, if there is none) was proved optimal
+        bool isProved()                     { return prover != -1;            }
+        double getBestValue()               { return bestValue;               }
+        bool hasBestBound()                 { return hasBound;                }
+        double getBestBound()               { return bestBound;               }
+};
+
+#endif
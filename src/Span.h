@@ -0,0 +1,40 @@
+/**
+ * Span.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SPAN_H
+#define SPAN_H
+
+#include "Util.h"
+
+/**
+ * Read-only view of a contiguous array owned by someone else, e.g. the solution handed to a callback.
+ * It is only valid while the array is.
+ */
+template <typename T>
+class Span {
+
+    private:
+
+        const T* ptr;
+        size_t   n;
+
+    public:
+
+        Span() : ptr(NULL), n(0) {}
+        Span(const T* p, size_t size) : ptr(p), n(size) {}
+        Span(const vector<T>& v) : ptr(v.data()), n(v.size()) {}
+
+        const T& operator[](size_t i) const { return ptr[i];     }
+        const T* data()               const { return ptr;        }
+        size_t   size()               const { return n;          }
+        bool     empty()              const { return n == 0;     }
+        const T* begin()              const { return ptr;        }
+        const T* end()                const { return ptr + n;    }
+};
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * ThreadPool.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "ThreadPool.h"
+
+/**
+ * INITIAL METHODS
+ *
+ */
+
+ThreadPool::ThreadPool(int numThreads) {
+    task     = NULL;
+    numTasks = 0;
+    next     = 0;
+    running  = 0;
+    job      = 0;
+    stopping = false;
+
+    if (numThreads == 0) numThreads = (int)std::thread::hardware_concurrency();
+    for (int t = 1; t < numThreads; t++) workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+/**
+ * JOBS
+ *
+ */
+
+void ThreadPool::run(int n, const std::function<void(int)>& f) {
+    std::unique_lock<std::mutex> owner(runLock, std::try_to_lock);
+    if (workers.empty() || n <= 1 || !owner.owns_lock()) {
+        for (int i = 0; i < n; i++) f(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        task     = &f;
+        numTasks = n;
+        next     = 0;
+        running  = (int)workers.size();
+        error    = NULL;
+        job++;
+    }
+    wake.notify_all();
+    runTasks();
+
+    // Workers may still be inside a task, or not have woken up at all, f must outlive them
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [this]() { return running == 0; });
+    task = NULL;
+    if (error) {
+        std::exception_ptr e = error;
+        error = NULL;
+        std::rethrow_exception(e);
+    }
+}
+
+void ThreadPool::work() {
+    unsigned long done = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this, done]() { return stopping || job != done; });
+            if (stopping) return;
+            done = job;
+        }
+
+        runTasks();
+
+        std::lock_guard<std::mutex> guard(lock);
+        if (--running == 0) finished.notify_all();
+    }
+}
+
+void ThreadPool::runTasks() {
+    for (int i = next++; i < numTasks; i = next++) {
+        try {
+            (*task)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!error) error = std::current_exception();
+        }
+    }
+}
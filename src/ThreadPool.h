@@ -0,0 +1,67 @@
+/**
+ * ThreadPool.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "Util.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Worker threads kept for the whole life of the pool, which run the tasks of one job at a time.
+ *
+ * run(numTasks, task) calls task(i) for every i in [0, numTasks), on the workers and on the calling
+ * thread, and returns once all calls are over. Tasks are taken in order by whichever thread is free,
+ * so a task must not depend on where or when another one runs. If another thread is already running
+ * a job the caller runs its tasks by itself, so callers (e.g. the callbacks of several solver threads)
+ * never wait for each other. An exception thrown by a task is rethrown by run.
+ */
+class ThreadPool {
+
+    private:
+
+        vector<std::thread> workers;
+
+        // Current job, and the workers that have not finished with it
+        std::mutex lock;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        const std::function<void(int)>* task;
+        int numTasks;
+        std::atomic<int> next;
+        int running;
+        unsigned long job;
+        bool stopping;
+        std::exception_ptr error;
+
+        // Held by the thread whose job is running
+        std::mutex runLock;
+
+        void work();
+        void runTasks();
+
+    public:
+
+        // numThreads counts the calling thread, 0 for the number of cores
+        ThreadPool(int numThreads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void run(int numTasks, const std::function<void(int)>& task);
+
+        int getNumThreads() { return (int)workers.size() + 1; }
+};
+
+#endif
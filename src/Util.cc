@@ -739,6 +739,116 @@ vector<vector<string>> Util::transposeStringMatrix(const vector<vector<string> >
 
 
 
+/**
+ * GRAPHS
+ *
+ */
+
+CSRGraph::CSRGraph() {
+    numNodes = 0;
+    first.push_back(0);
+}
+
+void CSRGraph::reset(int n) {
+    numNodes = n;
+    arcTails.clear();
+    arcHeads.clear();
+    arcWeights.clear();
+    first.assign(n + 1, 0);
+    heads.clear();
+    weights.clear();
+}
+
+void CSRGraph::addArc(int tail, int head, double weight) {
+    arcTails.push_back(tail);
+    arcHeads.push_back(head);
+    arcWeights.push_back(weight);
+}
+
+// Counting sort of the arcs by tail, which keeps the order in which they were added
+void CSRGraph::build() {
+    std::fill(first.begin(), first.end(), 0);
+    for (int tail : arcTails) first[tail + 1]++;
+    for (int v = 0; v < numNodes; v++) first[v + 1] += first[v];
+
+    heads.resize(arcTails.size());
+    weights.resize(arcTails.size());
+    for (unsigned i = 0; i < arcTails.size(); i++) {
+        int a = first[arcTails[i]]++;
+        heads[a]   = arcHeads[i];
+        weights[a] = arcWeights[i];
+    }
+    for (int v = numNodes; v > 0; v--) first[v] = first[v - 1];
+    first[0] = 0;
+}
+
+GraphSearch::GraphSearch() {
+    epoch = 0;
+}
+
+void GraphSearch::clear(int numNodes) {
+    if ((int)mark.size() < numNodes) {
+        mark.resize(numNodes, 0);
+        ring.resize(numNodes);
+    }
+    if (++epoch == 0) {
+        std::fill(mark.begin(), mark.end(), 0);
+        epoch = 1;
+    }
+}
+
+int GraphSearch::bfs(const CSRGraph& graph, int start, vector<int>& reached) {
+    if (isVisited(start)) return 0;
+    int size = (int)ring.size();
+    int head = 0;
+    int tail = 0;
+    int count = 0;
+
+    visit(start);
+    ring[tail] = start;
+    tail = (tail + 1) % size;
+    count++;
+    int numReached = 0;
+    while (count > 0) {
+        int v = ring[head];
+        head = (head + 1) % size;
+        count--;
+        reached.push_back(v);
+        numReached++;
+
+        for (int a = graph.begin(v); a < graph.end(v); a++) {
+            int w = graph.getHead(a);
+            if (isVisited(w)) continue;
+            visit(w);
+            ring[tail] = w;
+            tail = (tail + 1) % size;
+            count++;
+        }
+    }
+    return numReached;
+}
+
+int GraphSearch::dfs(const CSRGraph& graph, int start, vector<int>& reached) {
+    int numReached = 0;
+    stack.clear();
+    stack.push_back(start);
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        if (isVisited(v)) continue;
+        visit(v);
+        reached.push_back(v);
+        numReached++;
+
+        // Pushed backwards, so that arcs are followed in their order
+        for (int a = graph.end(v) - 1; a >= graph.begin(v); a--) {
+            if (!isVisited(graph.getHead(a))) stack.push_back(graph.getHead(a));
+        }
+    }
+    return numReached;
+}
+
+
 /////////////////////////
 /////////////////////////
 /////////////////////////
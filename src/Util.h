@@ -25,6 +25,7 @@
 #define TOLERANCE                       1e-6
 #define TOLERANCE_VIOLATION             1e-5
 #define UND                              "_"
+#define CACHE_LINE_SIZE                   64
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -240,4 +241,71 @@ class Util {
         }
 };    
 
+/**
+ * Directed graph in compressed sparse row form: the arcs leaving node v are [begin(v), end(v)), in the
+ * order they were added. The graph is given arc by arc and built once, reset keeps the memory so that
+ * the same object can be refilled at every call of a callback.
+ */
+class CSRGraph {
+
+    private:
+
+        int numNodes;
+        vector<int>    first;
+        vector<int>    heads;
+        vector<double> weights;
+
+        // Arcs as given, until build
+        vector<int>    arcTails;
+        vector<int>    arcHeads;
+        vector<double> arcWeights;
+
+    public:
+
+        CSRGraph();
+
+        // Starts a new graph with numNodes nodes and no arcs
+        void reset(int numNodes);
+        void addArc(int tail, int head, double weight = 1);
+        void build();
+
+        int    getNumNodes()     const { return numNodes;          }
+        int    getNumArcs()      const { return (int)heads.size(); }
+        int    begin(int v)      const { return first[v];          }
+        int    end(int v)        const { return first[v + 1];      }
+        int    getHead(int a)    const { return heads[a];          }
+        double getWeight(int a)  const { return weights[a];        }
+};
+
+/**
+ * Workspace of breadth- and depth-first searches over a CSRGraph, reused from search to search.
+ *
+ * Visited nodes are stamped with the current epoch, so forgetting them (clear) takes constant time and
+ * several searches can share the marks (e.g. to find components). The BFS queue is a ring buffer of
+ * one slot per node, as no node is queued twice.
+ */
+class GraphSearch {
+
+    private:
+
+        vector<unsigned> mark;
+        unsigned epoch;
+        vector<int> ring;
+        vector<int> stack;
+
+    public:
+
+        GraphSearch();
+
+        // Forgets the visited nodes, for a graph with up to numNodes nodes
+        void clear(int numNodes);
+        bool isVisited(int v) const { return mark[v] == epoch; }
+        void visit(int v)           { mark[v] = epoch;         }
+
+        // Visit the nodes reachable from start that were not visited yet, appending them to reached
+        // in the order they are visited. Return how many
+        int bfs(const CSRGraph& graph, int start, vector<int>& reached);
+        int dfs(const CSRGraph& graph, int start, vector<int>& reached);
+};
+
 #endif 
@@ -0,0 +1,180 @@
+/**
+ * VarFamily.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef VARFAMILY_H
+#define VARFAMILY_H
+
+#include "Solver.h"
+#include <array>
+
+/**
+ * Family of variables indexed by an N-dimensional tuple, e.g. x[k][i][j].
+ *
+ * All columns of a family are created at once and occupy a contiguous block
+ * [firstCol, firstCol + numCols) in the solver, in row-major order of the tuples.
+ * Tuples can be masked out (e.g. i == j), in which case no column is created for them.
+ *
+ * Solution values are read straight from the solver solution vector:
+ *
+ *     const double* sol = solver->getColValues();
+ *     double v = x.value(sol, k, i, j);
+ */
+template <int N>
+class VarFamily {
+
+    public:
+
+        typedef std::array<int, N> Tuple;
+
+    private:
+
+        string name;
+        int firstCol;
+        int numCols;
+        Tuple dims;
+        int numTuples;
+
+        // Only used if the family is masked
+        // tuple (row-major position) -> column offset, -1 if masked
+        vector<int> tupleToCol;
+        // column offset -> tuple (row-major position)
+        vector<int> colToTuple;
+
+        // Offset of the first column of each value of the first index
+        vector<int> leadingStart;
+
+        int position(const Tuple& t) const {
+            int p = 0;
+            for (int d = 0; d < N; d++) p = p * dims[d] + t[d];
+            return p;
+        }
+
+        Tuple tuple(int p) const {
+            Tuple t;
+            for (int d = N - 1; d >= 0; d--) {
+                t[d] = p % dims[d];
+                p /= dims[d];
+            }
+            return t;
+        }
+
+    public:
+
+        VarFamily() {
+            firstCol  = -1;
+            numCols   = 0;
+            numTuples = 0;
+            dims.fill(0);
+        }
+
+        ~VarFamily() {}
+
+        // Names are generated from the family itself (see create), so it cannot be copied
+        VarFamily(const VarFamily&) = delete;
+        VarFamily& operator=(const VarFamily&) = delete;
+
+        /**
+         * solver -> where columns are created
+         * type   -> 'B' binary, 'I' integer or 'C' continuous
+         * lb, ub -> bounds of all variables (ignored if binary)
+         * n      -> family name, columns are named n + i0 + "_" + i1 + ... (only when needed, see Solver::setColNames)
+         * d      -> size of each dimension
+         * obj    -> objective coefficient of each tuple
+         * mask   -> if given, only tuples for which it is true have a column
+         */
+        void create(Solver* solver, char type, double lb, double ub, const string& n, const Tuple& d,
+                    std::function<double(const Tuple&)> obj, std::function<bool(const Tuple&)> mask = nullptr) {
+            name = n;
+            dims = d;
+            numTuples = 1;
+            for (int i = 0; i < N; i++) numTuples *= dims[i];
+
+            tupleToCol.clear();
+            colToTuple.clear();
+            leadingStart.assign(dims[0] + 1, 0);
+
+            vector<double> objs;
+            objs.reserve(numTuples);
+            if (mask) tupleToCol.assign(numTuples, -1);
+            
+            int perLeading = numTuples / (dims[0] > 0 ? dims[0] : 1);
+            for (int p = 0; p < numTuples; p++) {
+                Tuple t = tuple(p);
+                if (p % perLeading == 0) leadingStart[p / perLeading] = (int)objs.size();
+                if (mask && !mask(t)) continue;
+                if (mask) {
+                    tupleToCol[p] = (int)objs.size();
+                    colToTuple.push_back(p);
+                }
+                objs.push_back(obj(t));
+            }
+            numCols = (int)objs.size();
+            leadingStart[dims[0]] = numCols;
+
+            firstCol = solver->getNumCols();
+            if (numCols == 0) return;
+
+            string noName = "";
+            if      (type == 'B') solver->addBinaryVariables (numCols,         &objs[0], noName);
+            else if (type == 'I') solver->addIntegerVariables(numCols, lb, ub, &objs[0], noName);
+            else if (type == 'C') solver->addVariables       (numCols, lb, ub, &objs[0], noName);
+            else Util::throwInvalidArgument("Error: Invalid variable type %c for family %s.", type, name.c_str());
+
+            solver->setColNames(firstCol, numCols, [this](int c) { return getName(c); });
+        }
+
+        /**
+         * Column index of a tuple, -1 if the tuple is masked
+         */
+        template <typename... I>
+        int col(I... idx) const {
+            static_assert(sizeof...(I) == N, "Wrong number of indices for VarFamily");
+            Tuple t = {{ idx... }};
+            int p = position(t);
+            if (tupleToCol.empty()) return firstCol + p;
+            return tupleToCol[p] == -1 ? -1 : firstCol + tupleToCol[p];
+        }
+
+        /**
+         * Value of a tuple in sol (a full solution vector, indexed by column), 0 if the tuple is masked
+         */
+        template <typename... I>
+        double value(const double* sol, I... idx) const {
+            int c = col(idx...);
+            return c == -1 ? 0 : sol[c];
+        }
+
+        /**
+         * Values of the whole family, the i-th column of the family is block(sol)[i]
+         */
+        const double* block(const double* sol) const { return sol + firstCol; }
+
+        /**
+         * Columns whose first index is i0 are [firstColOf(i0), firstColOf(i0 + 1))
+         */
+        int firstColOf(int i0) const { return firstCol + leadingStart[i0]; }
+
+        /**
+         * Tuple of the i-th column of the family
+         */
+        Tuple getTuple(int i) const { return tuple(colToTuple.empty() ? i : colToTuple[i]); }
+
+        string getName(int i) const {
+            Tuple t = getTuple(i);
+            string n = name + lex(t[0]);
+            for (int d = 1; d < N; d++) n += UND + lex(t[d]);
+            return n;
+        }
+
+        int getFirstCol()     const { return firstCol;  }
+        int getNumCols()      const { return numCols;   }
+        int getDim(int d)     const { return dims[d];   }
+        bool isMasked()       const { return !tupleToCol.empty(); }
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * BranchAndBoundTest.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Test.h"
+#include "ModelIR.h"
+#include "BranchAndBound.h"
+#include <cmath>
+
+// max 5x0 + 4x1 + 3x2 s.t. 2x0 + 3x1 + x2 <= 5, 4x0 + x1 + 2x2 <= 11, 3x0 + 4x1 + 2x2 <= 8, binary
+static void loadKnapsack(BranchAndBound& bb) {
+    ModelIR ir;
+    ir.setMaximisation(true);
+
+    double obj[]   = {5, 4, 3};
+    double lower[] = {0, 0, 0};
+    double upper[] = {1, 1, 1};
+    ir.addColumns(3, obj, lower, upper, 'B');
+    int    ind[] = {0, 1, 2};
+    double row0[] = {2, 3, 1};
+    double row1[] = {4, 1, 2};
+    double row2[] = {3, 4, 2};
+    ir.addRow(3, ind, row0, 5,  'L');
+    ir.addRow(3, ind, row1, 11, 'L');
+    ir.addRow(3, ind, row2, 8,  'L');
+
+    bb.loadModel(ir);
+}
+
+static void testOptimal() {
+    BranchAndBound bb;
+    loadKnapsack(bb);
+    bb.solve();
+
+    CHECK(bb.isOptimal());
+    CHECK(!bb.isNumericalDifficulties());
+    CHECK(fabs(bb.getObjValue() - 9) < 1e-6);
+}
+
+// A node whose LP stops on the iteration limit is not explored, the tree is not closed
+static void testIterationLimit() {
+    BranchAndBound bb;
+    loadKnapsack(bb);
+    bb.setIterationLimit(1);
+    bb.solve();
+
+    CHECK(!bb.isOptimal());
+    CHECK(!bb.isInfeasible());
+    CHECK(bb.isNumericalDifficulties());
+    CHECK(bb.getBestBound() > 9);
+}
+
+int main() {
+    testOptimal();
+    testIterationLimit();
+    printf("Branch-and-bound tests passed\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * CutPoolTest.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Test.h"
+#include "Options.h"
+#include "Model.h"
+#include <condition_variable>
+#include <thread>
+
+// Separates x0 + x1 <= 1. The first call waits inside the separation until the test lets it go on,
+// so that another thread can separate and pool the same cut meanwhile
+class RaceModel : public Model {
+
+    public:
+
+        std::mutex lock;
+        std::condition_variable changed;
+        bool firstSeparating;
+        bool released;
+
+        RaceModel() : Model() {
+            parallelCallbacks = true;
+            firstSeparating   = false;
+            released          = false;
+        }
+
+        void separationAlgorithm(Span<double> sol, CutBuffer& cuts) {
+            if (sol[0] + sol[1] > 1) {
+                cuts.addCoef(0, 1);
+                cuts.addCoef(1, 1);
+                cuts.addCut('L', 1);
+            }
+
+            std::unique_lock<std::mutex> guard(lock);
+            if (firstSeparating) return;
+            firstSeparating = true;
+            changed.notify_all();
+            changed.wait(guard, [this]() { return released; });
+        }
+};
+
+// Cuts already pooled are dropped from a separation unless they are violated
+static void testDuplicates() {
+    double x[] = {1, 1};
+    double y[] = {0.5, 0.5};
+    CutPool pool;
+    pool.setMaxAge(10);
+
+    CutBuffer first;
+    first.addCoef(0, 1); first.addCoef(1, 1); first.addCut('L', 1);
+    CHECK(pool.add(first, 0, x, TOLERANCE) == 0);
+    CHECK(pool.getNumCuts() == 1);
+
+    // Same cut, coefficients in another order, repeated in the buffer
+    CutBuffer again;
+    again.addCoef(1, 1); again.addCoef(0, 1); again.addCut('L', 1);
+    again.addCoef(0, 1); again.addCoef(1, 1); again.addCut('L', 1);
+    CHECK(pool.add(again, 0, y, TOLERANCE) == 2);
+    CHECK(again.getNumCuts() == 0);
+
+    CutBuffer violated;
+    violated.addCoef(1, 1); violated.addCoef(0, 1); violated.addCut('L', 1);
+    violated.addCoef(0, 1); violated.addCoef(1, 1); violated.addCut('L', 1);
+    CHECK(pool.add(violated, 0, x, TOLERANCE) == 1);
+    CHECK(violated.getNumCuts() == 1);
+    CHECK(pool.getNumCuts() == 1);
+}
+
+// Two threads separate the same violated point, the second one pools the cut while the first one is
+// still separating it. Both must get the cut back
+static void testConcurrentSeparation() {
+    RaceModel model;
+    double x[] = {1, 1};
+    CutBuffer firstCuts;
+    CutBuffer secondCuts;
+
+    std::thread first([&]() { model.separate(Span<double>(x, 2), firstCuts); });
+    {
+        std::unique_lock<std::mutex> guard(model.lock);
+        model.changed.wait(guard, [&]() { return model.firstSeparating; });
+    }
+
+    std::thread second([&]() { model.separate(Span<double>(x, 2), secondCuts); });
+    second.join();
+    {
+        std::lock_guard<std::mutex> guard(model.lock);
+        model.released = true;
+    }
+    model.changed.notify_all();
+    first.join();
+
+    CHECK(secondCuts.getNumCuts() == 1);
+    CHECK(firstCuts.getNumCuts() == 1);
+    CHECK(firstCuts.isViolated(0, x, TOLERANCE));
+}
+
+int main() {
+    // No data is read, input is only required by the options
+    char  program[] = "CutPoolTest";
+    char  input[]   = "--input=none";
+    char  solver[]  = "--solver=native";
+    char  poolAge[] = "--cut_pool_age=10";
+    char  debug[]   = "--debug=0";
+    char* argv[]    = {program, input, solver, poolAge, debug};
+    Options::getInstance()->factory();
+    Options::getInstance()->parseOptions(5, argv);
+
+    testDuplicates();
+    testConcurrentSeparation();
+
+    Options::finalise();
+    printf("CutPool tests passed\n");
+    return 0;
+}
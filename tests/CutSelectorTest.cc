@@ -0,0 +1,45 @@
+/**
+ * CutSelectorTest.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Test.h"
+#include "CutSelector.h"
+#include <cmath>
+
+// Enough coefficients for the candidates to be scored on the pool
+static void testParallelScores() {
+    const int numCols = 1000, numCuts = 300, numCoefs = 500;
+    vector<double> x(numCols);
+    for (int j = 0; j < numCols; j++) x[j] = (j % 7) / 7.0;
+
+    CutBuffer cuts;
+    for (int i = 0; i < numCuts; i++) {
+        for (int k = 0; k < numCoefs; k++) cuts.addCoef((i * 31 + k * 7) % numCols, 1 + (i + k) % 5);
+        cuts.addCut('L', 3 * i);
+    }
+
+    CutSelector selector;
+    vector<char> decisions;
+    selector.select(cuts, &x[0], 1e-6, 0, 1, decisions);
+
+    for (int i = 0; i < numCuts; i++) {
+        double activity = 0, norm = 0;
+        for (int k = cuts.getBegin(i); k < cuts.getEnd(i); k++) {
+            activity += cuts.getRowVal()[k] * x[cuts.getRowInd()[k]];
+            norm     += cuts.getRowVal()[k] * cuts.getRowVal()[k];
+        }
+        CHECK(fabs(selector.getEfficacy(i) - (activity - 3 * i) / sqrt(norm)) < 1e-9);
+        // Nothing is too parallel to keep and there is no budget, every violated cut is added
+        CHECK((decisions[i] != CUT_DROPPED) == (activity - 3 * i > 1e-6));
+    }
+}
+
+int main() {
+    testParallelScores();
+    printf("Cut selector tests passed\n");
+    return 0;
+}
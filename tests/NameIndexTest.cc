@@ -0,0 +1,83 @@
+/**
+ * NameIndexTest.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Test.h"
+#include "NameIndex.h"
+#include <cstring>
+
+static bool hasName(const NameIndex& names, int index, const char* name) {
+    const char* n = names.getName(index);
+    return n != NULL && strcmp(n, name) == 0;
+}
+
+static void testLookup() {
+    NameIndex names;
+    names.add("x_0", 0);
+    names.add("x_1", 1);
+    names.add("y", 4);
+
+    CHECK(names.getNumNames() == 3);
+    CHECK(names.find("x_0") == 0);
+    CHECK(names.find("x_1") == 1);
+    CHECK(names.find("y") == 4);
+    CHECK(names.find("z") == -1);
+    CHECK(hasName(names, 0, "x_0"));
+    CHECK(hasName(names, 4, "y"));
+    CHECK(names.getName(2) == NULL);
+    CHECK(names.getName(10) == NULL);
+}
+
+static void testRehash() {
+    NameIndex names;
+    for (int i = 0; i < 10000; i++) names.add("c" + std::to_string(i), i);
+
+    CHECK(names.getNumNames() == 10000);
+    for (int i = 0; i < 10000; i++) {
+        CHECK(names.find("c" + std::to_string(i)) == i);
+        CHECK(hasName(names, i, ("c" + std::to_string(i)).c_str()));
+    }
+}
+
+// A name given a new index no longer names its old one
+static void testReassignment() {
+    NameIndex names;
+    names.add("a", 0);
+    names.add("b", 1);
+    names.add("a", 2);
+
+    CHECK(names.getNumNames() == 2);
+    CHECK(names.find("a") == 2);
+    CHECK(hasName(names, 2, "a"));
+    CHECK(names.getName(0) == NULL);
+    CHECK(hasName(names, 1, "b"));
+
+    // Index 3 was named "d" after "c", moving "c" away must leave it named "d"
+    names.add("c", 3);
+    names.add("d", 3);
+    names.add("c", 4);
+    CHECK(names.find("c") == 4);
+    CHECK(hasName(names, 4, "c"));
+    CHECK(hasName(names, 3, "d"));
+
+    // Reassigned before and after a rehash
+    for (int i = 0; i < 1000; i++) names.add("r" + std::to_string(i), 100 + i);
+    for (int i = 0; i < 1000; i++) names.add("r" + std::to_string(i), 2000 + i);
+    for (int i = 0; i < 1000; i++) {
+        CHECK(names.find("r" + std::to_string(i)) == 2000 + i);
+        CHECK(names.getName(100 + i) == NULL);
+        CHECK(hasName(names, 2000 + i, ("r" + std::to_string(i)).c_str()));
+    }
+}
+
+int main() {
+    testLookup();
+    testRehash();
+    testReassignment();
+    printf("NameIndex tests passed\n");
+    return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * SolverLoadTest.cc
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Test.h"
+#include "ModelIR.h"
+#include "Simplex.h"
+#include <cmath>
+
+// Binary columns keep the bounds of the IR when it is loaded, as branch and bound does
+static void testBinaryBounds() {
+    ModelIR ir;
+    ir.setMaximisation(true);
+
+    // x0 fixed to 1, x1 free in [0, 1], x2 and x3 fixed to 0
+    double obj[]   = {1, 1, 1, 1};
+    double lower[] = {1, 0, 0, 0};
+    double upper[] = {1, 1, 0, 0};
+    for (int c = 0; c < 4; c++) ir.addColumns(1, &obj[c], &lower[c], &upper[c], 'B');
+    int    ind[] = {0, 1, 2, 3};
+    double val[] = {1, 1, 1, 1};
+    ir.addRow(4, ind, val, 4, 'L');
+
+    Simplex lp;
+    lp.loadModel(ir);
+    lp.relax();
+    lp.solve();
+
+    CHECK(lp.isOptimal());
+    CHECK(fabs(lp.getObjValue() - 2) < 1e-9);
+    const double* x = lp.getColValues();
+    CHECK(fabs(x[0] - 1) < 1e-9);
+    CHECK(fabs(x[1] - 1) < 1e-9);
+    CHECK(fabs(x[2]) < 1e-9);
+    CHECK(fabs(x[3]) < 1e-9);
+}
+
+int main() {
+    testBinaryBounds();
+    printf("Solver load tests passed\n");
+    return 0;
+}
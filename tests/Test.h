@@ -0,0 +1,23 @@
+/**
+ * Test.h
+ *
+ * Copyright(c) 2018
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// Fails the test, with the file and line, if cond does not hold
+#define CHECK(cond) do {                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#endif